@@ -0,0 +1,134 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+// Allocation heavy workload for comparing malloc implementations. Each
+// thread keeps a table of live objects and replaces a random one per
+// operation, with sizes skewed towards small objects like most programs.
+// Run it once normally and once with LD_PRELOAD=libcpool_malloc.so.
+//
+// usage: bench_malloc [-t threads] [-n operations per thread] [-s slots per thread]
+//
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct bench_thread_t {
+    pthread_t thread;
+    size_t    operations;
+    size_t    slots;
+    uint64_t  seed;
+    uint64_t  checksum;
+} bench_thread_t;
+
+static uint64_t bench_random(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+static size_t bench_size(uint64_t random) {
+    unsigned percent = (unsigned) (random % 1000);
+
+    random >>= 10;
+    if (percent < 800) {
+        return 16 + random % 112;
+    } else if (percent < 950) {
+        return 128 + random % 896;
+    } else if (percent < 999) {
+        return 1024 + random % 15360;
+    }
+    return 65536 + random % 458752;
+}
+
+static void *bench_run(void *argument) {
+    bench_thread_t *bench = argument;
+    char           **slots = calloc(bench->slots, sizeof(char *));
+    size_t         slot, size;
+    uint64_t       random;
+
+    for (size_t i = 0; i < bench->operations && slots != NULL; i++) {
+        random = bench_random(&bench->seed);
+        slot   = random % bench->slots;
+
+        if (slots[slot] != NULL) {
+            bench->checksum += (unsigned char) slots[slot][0];
+            free(slots[slot]);
+        }
+
+        size = bench_size(random >> 20);
+        slots[slot] = malloc(size);
+        if (slots[slot] != NULL) {
+            slots[slot][0]        = (char) size;
+            slots[slot][size - 1] = (char) size;
+        }
+    }
+
+    for (size_t i = 0; slots != NULL && i < bench->slots; i++) {
+        free(slots[i]);
+    }
+    free(slots);
+    return NULL;
+}
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    size_t         threads    = 1;
+    size_t         operations = 10000000;
+    size_t         slots      = 1000;
+    bench_thread_t *benches;
+    double         start, elapsed;
+    struct rusage  usage;
+    int            option;
+
+    while ((option = getopt(argc, argv, "t:n:s:h")) != -1) {
+        switch (option) {
+            case 't':
+                threads = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                operations = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                slots = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: bench_malloc [-t threads] [-n operations per thread] [-s slots per thread]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (threads == 0 || slots == 0 || (benches = calloc(threads, sizeof(bench_thread_t))) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    start = bench_now();
+    for (size_t i = 0; i < threads; i++) {
+        benches[i].operations = operations;
+        benches[i].slots      = slots;
+        benches[i].seed       = 0x9E3779B97F4A7C15ull * (i + 1);
+        pthread_create(&benches[i].thread, NULL, bench_run, &benches[i]);
+    }
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(benches[i].thread, NULL);
+    }
+    elapsed = bench_now() - start;
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf("threads %zu: %.2f Mops/s, max rss %ld KiB\n", threads, threads * operations / elapsed / 1e6,
+           usage.ru_maxrss);
+
+    free(benches);
+    return EXIT_SUCCESS;
+}
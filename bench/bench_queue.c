@@ -0,0 +1,123 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+// Throughput of the pooled lock-free containers. Every thread pushes and
+// then pops in bursts against one shared queue or stack, the node pool is
+// sized so pushes never fail.
+//
+// usage: bench_queue [-c queue|stack] [-t threads] [-n operations per thread] [-b burst]
+//
+
+#include "pool_queue.h"
+#include "pool_stack.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct bench_thread_t {
+    pthread_t thread;
+    size_t    operations;
+    size_t    burst;
+    uint64_t  checksum;
+} bench_thread_t;
+
+static pool_queue_t bench_queue;
+static pool_stack_t bench_stack;
+static int          bench_use_stack;
+
+static int bench_push(void *value) {
+    return bench_use_stack ? pool_stack_push(&bench_stack, value) : pool_queue_push(&bench_queue, value);
+}
+
+static int bench_pop(void **value) {
+    return bench_use_stack ? pool_stack_pop(&bench_stack, value) : pool_queue_pop(&bench_queue, value);
+}
+
+static void *bench_run(void *argument) {
+    bench_thread_t *bench = argument;
+    void           *value;
+
+    for (size_t done = 0; done < bench->operations; done += 2 * bench->burst) {
+        for (size_t i = 0; i < bench->burst; i++) {
+            bench_push((void *) (uintptr_t) (done + i));
+        }
+        for (size_t i = 0; i < bench->burst; i++) {
+            if (bench_pop(&value)) {
+                bench->checksum += (uintptr_t) value;
+            }
+        }
+    }
+    return NULL;
+}
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    size_t         threads    = 1;
+    size_t         operations = 10000000;
+    size_t         burst      = 16;
+    bench_thread_t *benches;
+    block_pool_t   pool;
+    size_t         nodes, arena;
+    void           *memory;
+    double         start, elapsed;
+    int            option;
+
+    while ((option = getopt(argc, argv, "c:t:n:b:h")) != -1) {
+        switch (option) {
+            case 'c':
+                bench_use_stack = strcmp(optarg, "stack") == 0;
+                break;
+            case 't':
+                threads = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                operations = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                burst = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: bench_queue [-c queue|stack] [-t threads] [-n operations per thread] "
+                                "[-b burst]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    nodes = threads * burst + 1;
+    arena = nodes * (POOL_NODE_SIZE + sizeof(void *)) + 2 * POOL_NODE_SIZE;
+    if (threads == 0 || burst == 0 || (benches = calloc(threads, sizeof(bench_thread_t))) == NULL
+        || (memory = malloc(arena)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    block_pool_init(&pool, POOL_NODE_SIZE, memory, (char *) memory + arena);
+    pool_queue_init(&bench_queue, &pool);
+    pool_stack_init(&bench_stack, &pool);
+
+    start = bench_now();
+    for (size_t i = 0; i < threads; i++) {
+        benches[i].operations = operations;
+        benches[i].burst      = burst;
+        pthread_create(&benches[i].thread, NULL, bench_run, &benches[i]);
+    }
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(benches[i].thread, NULL);
+    }
+    elapsed = bench_now() - start;
+
+    printf("%s threads %zu: %.2f Mops/s\n", bench_use_stack ? "stack" : "queue", threads,
+           threads * operations / elapsed / 1e6);
+
+    free(benches);
+    free(memory);
+    return EXIT_SUCCESS;
+}
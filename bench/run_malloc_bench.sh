@@ -0,0 +1,17 @@
+#!/bin/sh
+#
+# Compare glibc malloc with libcpool_malloc.so on bench_malloc
+#
+# usage: bench/run_malloc_bench.sh <build directory> [thread counts...]
+#
+
+BUILD=${1:-build}
+shift
+THREADS=${*:-1 2 4 8}
+
+for threads in $THREADS; do
+    printf "glibc  "
+    "$BUILD/bench_malloc" -t "$threads"
+    printf "cpool  "
+    LD_PRELOAD="$BUILD/libcpool_malloc.so" "$BUILD/bench_malloc" -t "$threads"
+done
@@ -0,0 +1,16 @@
+#!/bin/sh
+#
+# Throughput of pool_queue_t and pool_stack_t from 1 to 64 threads
+#
+# usage: bench/run_queue_bench.sh <build directory> [thread counts...]
+#
+
+BUILD=${1:-build}
+shift
+THREADS=${*:-1 2 4 8 16 32 64}
+
+for container in queue stack; do
+    for threads in $THREADS; do
+        "$BUILD/bench_queue" -c "$container" -t "$threads"
+    done
+done
@@ -0,0 +1,88 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_BLOCK_CLASS_H
+#define MEMORY_BLOCK_CLASS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "block_pool.h"
+
+#ifndef BLOCK_CLASS_MAX
+#define BLOCK_CLASS_MAX 16 /* most block pools one front end can tune, no more than 32 */
+#endif
+
+#ifndef BLOCK_CLASS_BUCKETS
+#define BLOCK_CLASS_BUCKETS 128 /* histogram buckets, requests above buckets * granule aren't counted */
+#endif
+
+/**
+ * Size class front end over caller initialized block pools. Every request
+ * is counted in a size histogram, and tuning picks the class sizes that
+ * waste the fewest bytes for the sizes seen so far. Pools move to their
+ * new size with block_pool_reset once they are empty, so wasted memory
+ * shrinks as the workload shifts without ever moving a live block.
+ */
+typedef struct block_class_pool_t {
+    block_pool_t      *pools;
+    size_t            count;
+    size_t            granule;                        /* histogram bucket width */
+    size_t            planned[BLOCK_CLASS_MAX];       /* size pools are rebuilt at once empty, 0 keeps the current size */
+    volatile uint32_t histogram[BLOCK_CLASS_BUCKETS];
+    volatile int      lock;
+} block_class_pool_t;
+
+/**
+ * Initialize size class front end
+ * @param classes
+ * @param pools     caller initialized block pools, one per class
+ * @param count     number of pools, at most BLOCK_CLASS_MAX
+ * @param granule   histogram bucket width, a multiple of sizeof(void*)
+ */
+void block_class_init(block_class_pool_t *classes, block_pool_t *pools, size_t count, size_t granule);
+
+int block_class_pool_is_valid(block_class_pool_t *classes);
+
+/**
+ * Allocate block from the smallest class that fits and has one free
+ * @param classes
+ * @param size
+ * @return pointer to block. Null if no class fitting size has a free block
+ */
+void *block_class_allocate(block_class_pool_t *classes, size_t size);
+
+/**
+ * Release block, rebuilding its pool at the planned size if this empties it
+ * @param classes
+ * @param memory
+ */
+void block_class_release(block_class_pool_t *classes, void *memory);
+
+/**
+ * Recompute class sizes from the histogram and rebuild pools that are empty
+ * @note Pools are handed to classes in order of memory, the largest pools
+ * going to the classes requesting the most bytes. The histogram is halved
+ * afterwards so older requests weigh less each time
+ * @param classes
+ * @return number of pools rebuilt at a new size
+ */
+size_t block_class_tune(block_class_pool_t *classes);
+
+/**
+ * Bytes the histogram's requests waste in the smallest class fitting them
+ * @param classes
+ * @param sizes     class sizes to measure, one per pool. Null for the current sizes
+ * @return wasted bytes, counting each request at the top of its bucket
+ */
+uint64_t block_class_waste(block_class_pool_t *classes, const size_t *sizes);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_BLOCK_CLASS_H
@@ -0,0 +1,97 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_BLOCK_EPOCH_H
+#define MEMORY_BLOCK_EPOCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "block_pool.h"
+
+#ifndef BLOCK_EPOCH_BATCH
+#define BLOCK_EPOCH_BATCH 64 /* retired blocks per thread before trying to reclaim */
+#endif
+
+typedef struct block_epoch_record_t block_epoch_record_t;
+
+/* per thread reclamation state, storage provided by the caller */
+struct block_epoch_record_t {
+    block_epoch_record_t *next;
+    volatile uint64_t    state;         /* epoch observed on entry << 1 | inside critical section */
+    void                 *retired[3];   /* blocks retired per epoch, linked through their headers */
+    uint64_t             epoch[3];      /* epoch each list was retired in */
+    size_t               count;         /* blocks waiting on a grace period */
+};
+
+/**
+ * Epoch based reclamation for blocks read by lock-free structures.
+ * Readers bracket accesses with enter and exit, retired blocks go back to
+ * the pool in batches once every thread inside a critical section has
+ * observed two epoch advances since the block was retired.
+ */
+typedef struct block_epoch_t {
+    block_pool_t                  *pool;
+    block_epoch_record_t *volatile records;
+    volatile uint64_t             epoch;
+} block_epoch_t;
+
+/**
+ * Initialize reclamation domain
+ * @param domain
+ * @param pool      pool retired blocks are released to, marked shared
+ */
+void block_epoch_init(block_epoch_t *domain, block_pool_t *pool);
+
+/**
+ * Register a thread's record, records stay registered for the life of the domain
+ * @param domain
+ * @param record    storage for the record, one per thread
+ */
+void block_epoch_register(block_epoch_t *domain, block_epoch_record_t *record);
+
+/**
+ * Enter critical section, blocks reachable inside it stay allocated until exit
+ * @param domain
+ * @param record    calling thread's record
+ */
+void block_epoch_enter(block_epoch_t *domain, block_epoch_record_t *record);
+
+/**
+ * Exit critical section
+ * @param record    calling thread's record
+ */
+void block_epoch_exit(block_epoch_record_t *record);
+
+/**
+ * Retire block unlinked from a shared structure, released once no reader can hold it
+ * @param domain
+ * @param record    calling thread's record
+ * @param block     block allocated from the domain's pool
+ */
+void block_epoch_retire(block_epoch_t *domain, block_epoch_record_t *record, void *block);
+
+/**
+ * Try to advance the epoch and release blocks past their grace period
+ * @param domain
+ * @param record    calling thread's record, outside a critical section
+ * @return number of blocks released
+ */
+size_t block_epoch_poll(block_epoch_t *domain, block_epoch_record_t *record);
+
+/**
+ * Wait until every block the record retired has been released, e.g. before the thread exits
+ * @param domain
+ * @param record    calling thread's record, outside a critical section
+ */
+void block_epoch_synchronize(block_epoch_t *domain, block_epoch_record_t *record);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_BLOCK_EPOCH_H
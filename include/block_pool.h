@@ -10,6 +10,8 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
+#include "pool_shrink.h"
 
 typedef struct block_pool_t {
     void *start;
@@ -18,6 +20,13 @@ typedef struct block_pool_t {
     size_t alignment;
     size_t capacity;
     size_t available;
+    volatile int      lock;
+    volatile uint32_t waiters;
+    volatile uint32_t wake;     /* futex word, bumped by releases while callers wait */
+    void              *untouched; /* blocks from here on have never been handed out */
+    int               zeroed;   /* untouched blocks read as zero */
+    int               shared;   /* used from several threads, operations take the lock */
+    pool_shrink_t     shrink;   /* shrinkers run when block_allocate fails or free bytes drop below the watermark */
 } block_pool_t;
 
 void block_pool_init(block_pool_t *pool, size_t alignment, void *start, void *end);
@@ -28,8 +37,61 @@ void block_pool_reset(block_pool_t *pool, size_t alignment);
 
 void *block_allocate(block_pool_t *pool);
 
+/**
+ * Allocate a block cleared to zero. Blocks never handed out are only
+ * cleared if the pool wasn't marked zeroed
+ * @param pool
+ * @return pointer to block. Null if pool is empty
+ */
+void *block_allocate_zeroed(block_pool_t *pool);
+
+/**
+ * Declare pool memory that hasn't been handed out yet to read as zero,
+ * e.g. fresh mmap or bss memory, so zeroed allocations skip clearing it
+ * @note Resetting to another block size forgets it, old headers lie inside the new blocks
+ * @param pool
+ */
+void block_pool_mark_zeroed(block_pool_t *pool);
+
+/**
+ * Declare pool shared between threads. Only shared pools take the pool
+ * lock, pools used from a single thread allocate and release without atomics
+ * @param pool
+ */
+void block_pool_mark_shared(block_pool_t *pool);
+
+/**
+ * Allocate a block, parking the caller until one is released if the pool is empty
+ * @note Only shared pools wait, anything else returns at once as no other thread can release
+ * @param pool
+ * @param timeout   nanoseconds to wait, UINT64_MAX waits forever
+ * @return pointer to block. Null if none was released within timeout
+ */
+void *block_allocate_wait(block_pool_t *pool, uint64_t timeout);
+
+/**
+ * Release block, waking one caller waiting on its pool
+ * @param block
+ */
 void block_release(void *block);
 
+/**
+ * Push allocated block onto a list of blocks to release later. The list is
+ * linked through block headers so block memory stays readable until release
+ * @param list      head of list, Null for an empty list
+ * @param block
+ * @return new head of list
+ */
+void *block_list_push(void *list, void *block);
+
+/**
+ * Release a list of blocks under a single lock
+ * @param pool      original owner of every block in the list
+ * @param list      head of list built with block_list_push
+ * @return number of blocks released
+ */
+size_t block_release_list(block_pool_t *pool, void *list);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,73 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_BYTE_COMPACT_POOL_H
+#define MEMORY_BYTE_COMPACT_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef BYTE_COMPACT_MIN
+#define BYTE_COMPACT_MIN 8 /* set minimum byte block size to reduce fragmentation */
+#endif
+
+#define BYTE_COMPACT_ALIGNMENT 8 /* header size and payload alignment */
+
+/**
+ * Byte pool variant with 8 byte headers holding 32 bit offsets from the
+ * start of the pool to the next and previous block, the low bit of next
+ * marking free blocks. Owners aren't stored per block so the pool must be
+ * passed on release. Free neighbours on both sides coalesce on release.
+ * @note Manages at most 4 GiB, payloads are 8 byte aligned
+ */
+typedef struct byte_compact_pool_t {
+    void     *start;
+    void     *end;          /* terminating header */
+    uint32_t search;        /* offset of the block the next search starts at */
+    size_t   capacity;      /* free bytes */
+    size_t   fragments;     /* free blocks */
+} byte_compact_pool_t;
+
+/**
+ * Initialize pool
+ * @param pool
+ * @param memory    aligned up to BYTE_COMPACT_ALIGNMENT
+ * @param size      clamped to 4 GiB
+ */
+void byte_compact_pool_init(byte_compact_pool_t *pool, void *memory, size_t size);
+
+int byte_compact_pool_is_valid(byte_compact_pool_t *pool);
+
+/**
+ * Allocate size bytes, rounded up to BYTE_COMPACT_ALIGNMENT
+ * @param pool
+ * @param size
+ * @return pointer to memory. Null if no free block is large enough
+ */
+void *byte_compact_allocate(byte_compact_pool_t *pool, size_t size);
+
+/**
+ * Release memory, coalescing with free neighbours
+ * @param pool      original owner of the memory
+ * @param memory
+ */
+void byte_compact_release(byte_compact_pool_t *pool, void *memory);
+
+/**
+ * Size of allocated memory
+ * @param pool      original owner of the memory
+ * @param memory
+ * @return number of usable bytes. Zero if memory isn't allocated from pool
+ */
+size_t byte_compact_size(byte_compact_pool_t *pool, void *memory);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_BYTE_COMPACT_POOL_H
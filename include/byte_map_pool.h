@@ -0,0 +1,90 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_BYTE_MAP_POOL_H
+#define MEMORY_BYTE_MAP_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pool_purge.h"
+
+#ifndef BYTE_MAP_GRANULE
+#define BYTE_MAP_GRANULE 16 /* allocation unit and alignment, power of two */
+#endif
+
+/* bytes of metadata needed to manage size bytes of memory */
+#define BYTE_MAP_METADATA_SIZE(size) \
+    (2 * sizeof(uint64_t) * (((size) / BYTE_MAP_GRANULE + 63) / 64))
+
+/**
+ * Byte pool variant that keeps block metadata out of line. Two bitmaps,
+ * one bit per granule, mark allocated granules and the last granule of
+ * each allocation. Searching scans the dense bitmap instead of chasing
+ * headers through user memory, free neighbours coalesce as soon as they
+ * are released and payloads carry no inline header.
+ */
+typedef struct byte_map_pool_t {
+    void     *start;
+    void     *end;
+    uint64_t *used;      /* bit per granule, set while allocated */
+    uint64_t *last;      /* bit per granule, set on the last granule of an allocation */
+    size_t   granules;
+    size_t   search;     /* granule the next search starts at */
+    size_t   capacity;   /* free bytes */
+    size_t   fragments;  /* free runs */
+} byte_map_pool_t;
+
+/**
+ * Initialize pool
+ * @param pool
+ * @param metadata      memory for the bitmaps, BYTE_MAP_METADATA_SIZE(size) bytes
+ * @param metadata_size
+ * @param memory        memory to manage, aligned up to BYTE_MAP_GRANULE
+ * @param size
+ */
+void byte_map_pool_init(byte_map_pool_t *pool, void *metadata, size_t metadata_size, void *memory, size_t size);
+
+int byte_map_pool_is_valid(byte_map_pool_t *pool);
+
+/**
+ * Allocate size bytes, rounded up to whole granules
+ * @param pool
+ * @param size
+ * @return pointer to memory. Null if no free run is large enough
+ */
+void *byte_map_allocate(byte_map_pool_t *pool, size_t size);
+
+/**
+ * Release memory, coalescing with free neighbours
+ * @param pool      original owner of the memory
+ * @param memory
+ */
+void byte_map_release(byte_map_pool_t *pool, void *memory);
+
+/**
+ * Size of allocated memory
+ * @param pool      original owner of the memory
+ * @param memory
+ * @return number of usable bytes. Zero if memory isn't allocated from pool
+ */
+size_t byte_map_size(byte_map_pool_t *pool, void *memory);
+
+/**
+ * Return whole pages inside free runs to the OS. The bitmaps live out of
+ * line so every free page can go.
+ * @param pool
+ * @param purge     rate limit, skipped until its interval and threshold are met
+ * @return number of bytes purged
+ */
+size_t byte_map_pool_purge(byte_map_pool_t *pool, pool_purge_t *purge);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_BYTE_MAP_POOL_H
@@ -10,6 +10,8 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include "pool_purge.h"
+#include "pool_shrink.h"
 
 #ifndef BYTE_BLOCK_MIN
 #define BYTE_BLOCK_MIN 16 /* set minimum byte block size to reduce fragmentation */
@@ -21,8 +23,30 @@ typedef struct byte_pool_t {
     void *end;
     size_t capacity;
     size_t fragments;
+    void *untouched;        /* memory from here on has never been handed out */
+    int zeroed;             /* untouched memory reads as zero */
+    pool_shrink_t shrink;   /* shrinkers run when allocations fail or capacity drops below the watermark */
 } byte_pool_t;
 
+typedef struct byte_handle_entry_t byte_handle_entry_t;
+
+/* handle table entry, storage provided by the caller */
+struct byte_handle_entry_t {
+    void                *memory;    /* current location, Null while the entry is free */
+    byte_handle_entry_t *next;      /* next free entry */
+    size_t              locks;
+};
+
+/* movable allocation, only dereferenced through byte_handle_lock */
+typedef byte_handle_entry_t *byte_handle_t;
+
+typedef struct byte_handle_table_t {
+    byte_pool_t         *pool;
+    byte_handle_entry_t *entries;
+    size_t              count;
+    byte_handle_entry_t *free;
+} byte_handle_table_t;
+
 void byte_pool_init(byte_pool_t *pool, void *memory, size_t size);
 
 int byte_pool_is_valid(byte_pool_t *pool);
@@ -33,8 +57,92 @@ void *byte_allocate(byte_pool_t *pool, size_t size);
 
 void byte_release(void *memory);
 
+/**
+ * Allocate memory cleared to zero. Memory never handed out is only
+ * cleared if the pool wasn't marked zeroed
+ * @param pool
+ * @param size      rounded up to a multiple of the pointer size
+ * @return pointer to memory. Null if no free block is large enough
+ */
+void *byte_allocate_zeroed(byte_pool_t *pool, size_t size);
+
+/**
+ * Declare pool memory that hasn't been handed out yet to read as zero,
+ * e.g. fresh mmap or bss memory, so zeroed allocations skip clearing it
+ * @param pool
+ */
+void byte_pool_mark_zeroed(byte_pool_t *pool);
+
 size_t byte_size(void *memory);
 
+/**
+ * Release many blocks at once. Pointers are sorted by address and each
+ * pool is swept once from its start, freeing the blocks and merging every
+ * run of free neighbours on the way, including blocks freed earlier.
+ * @note Sorts ptrs in place. Null, duplicate and already free pointers are skipped
+ * @param ptrs      memory to release, may come from several pools
+ * @param count     number of pointers
+ * @return number of blocks released
+ */
+size_t byte_release_batch(void **ptrs, size_t count);
+
+/**
+ * Return whole pages inside free blocks to the OS. Free neighbours are
+ * merged first and block headers are left in place, so the pool is
+ * unchanged apart from purged pages reading back as zero.
+ * @param pool
+ * @param purge     rate limit, skipped until its interval and threshold are met
+ * @return number of bytes purged
+ */
+size_t byte_pool_purge(byte_pool_t *pool, pool_purge_t *purge);
+
+/**
+ * Initialize handle table for movable allocations from pool
+ * @param table
+ * @param pool      initialized pool, may also serve byte_allocate
+ * @param entries   memory for count entries
+ * @param count     maximum number of live handles
+ */
+void byte_handle_table_init(byte_handle_table_t *table, byte_pool_t *pool, byte_handle_entry_t *entries, size_t count);
+
+/**
+ * Allocate movable memory, compacting the pool once if no free block is large enough
+ * @param table
+ * @param size
+ * @return handle. Null if out of memory or handles
+ */
+byte_handle_t byte_handle_allocate(byte_handle_table_t *table, size_t size);
+
+/**
+ * Release movable memory
+ * @param table
+ * @param handle    unlocked handle
+ */
+void byte_handle_release(byte_handle_table_t *table, byte_handle_t handle);
+
+/**
+ * Pin memory in place, locks nest
+ * @note Release through the table, byte_release and byte_size ignore handle memory
+ * @param handle
+ * @return pointer to memory, valid until the matching unlock
+ */
+void *byte_handle_lock(byte_handle_t handle);
+
+/**
+ * Unpin memory, it may move once every lock is released
+ * @param handle
+ */
+void byte_handle_unlock(byte_handle_t handle);
+
+/**
+ * Slide unlocked handle memory toward the start of the pool so free space
+ * gathers into a single block. Locked handles and byte_allocate memory
+ * stay in place, free space between them is merged.
+ * @param table
+ * @return number of blocks moved
+ */
+size_t byte_pool_compact(byte_handle_table_t *table);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,57 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_CPOOL_MALLOC_H
+#define MEMORY_CPOOL_MALLOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*
+ * General purpose allocator built on the pools. Small requests are served
+ * by size class block pools with a per-thread cache, mid sizes by byte
+ * pools and huge requests are mapped directly.
+ *
+ * libcpool_malloc.so exports these as malloc, free, etc. so unmodified
+ * programs can run on it with LD_PRELOAD.
+ */
+
+#ifndef CPOOL_MALLOC_HUGE
+#define CPOOL_MALLOC_HUGE (256u << 10) /* requests above this are mapped directly */
+#endif
+
+void *cpool_malloc(size_t size);
+
+void cpool_free(void *memory);
+
+void *cpool_calloc(size_t count, size_t size);
+
+void *cpool_realloc(void *memory, size_t size);
+
+/**
+ * Allocate aligned memory
+ * @param memory    set to the allocated memory
+ * @param alignment power of two multiple of sizeof(void*)
+ * @param size
+ * @return 0 on success, EINVAL for bad alignment or ENOMEM
+ */
+int cpool_posix_memalign(void **memory, size_t alignment, size_t size);
+
+void *cpool_aligned_alloc(size_t alignment, size_t size);
+
+/**
+ * Number of bytes usable at memory, at least the size requested
+ * @param memory
+ * @return
+ */
+size_t cpool_malloc_usable_size(void *memory);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_CPOOL_MALLOC_H
@@ -0,0 +1,117 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_CHAIN_H
+#define MEMORY_POOL_CHAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "block_pool.h"
+#include "byte_pool.h"
+
+typedef enum pool_tier_type_t {
+    POOL_TIER_BLOCK,
+    POOL_TIER_BYTE,
+    POOL_TIER_SYSTEM,
+} pool_tier_type_t;
+
+typedef struct pool_tier_t pool_tier_t;
+
+/* one pool in a chain, storage provided by the caller */
+struct pool_tier_t {
+    pool_tier_t *next;              /* next tier to spill to */
+    int         type;               /* pool_tier_type_t */
+    void        *pool;              /* block_pool_t or byte_pool_t */
+    void        *start;             /* memory range owned by the tier */
+    void        *end;
+    size_t      size;               /* largest allocation served */
+    void        *(*allocate)(size_t size);
+    void        (*release)(void *memory);
+};
+
+/**
+ * Ordered list of pools, allocation spills to the next tier when a tier
+ * can't serve a request. Tiers owning memory are indexed by address so
+ * release finds the owner with a binary search, anything outside them
+ * goes to the system tier.
+ */
+typedef struct pool_chain_t {
+    pool_tier_t *first;
+    pool_tier_t *last;
+    pool_tier_t *system;
+    pool_tier_t **index;            /* tiers sorted by start address */
+    size_t      count;
+    size_t      capacity;
+    size_t      spills;             /* allocations served past the first tier that fits */
+} pool_chain_t;
+
+/**
+ * Initialize empty chain
+ * @param chain
+ * @param index     memory for capacity tier pointers
+ * @param capacity  maximum number of block and byte tiers
+ */
+void pool_chain_init(pool_chain_t *chain, pool_tier_t **index, size_t capacity);
+
+/**
+ * Append block pool, serving requests up to its block size
+ * @param chain
+ * @param tier      storage for the tier, must outlive the chain
+ * @param pool      initialized pool
+ * @return true if added. False if the index is full or pool overlaps another tier
+ */
+int pool_chain_add_block(pool_chain_t *chain, pool_tier_t *tier, block_pool_t *pool);
+
+/**
+ * Append byte pool, serving requests of any size
+ * @param chain
+ * @param tier      storage for the tier, must outlive the chain
+ * @param pool      initialized pool
+ * @return true if added. False if the index is full or pool overlaps another tier
+ */
+int pool_chain_add_byte(pool_chain_t *chain, pool_tier_t *tier, byte_pool_t *pool);
+
+/**
+ * Append system allocator, owning every pointer outside the pool tiers
+ * @note Only one system tier may be added
+ * @param chain
+ * @param tier      storage for the tier, must outlive the chain
+ * @param allocate  malloc or equivalent
+ * @param release   free or equivalent
+ * @return true if added
+ */
+int pool_chain_add_system(pool_chain_t *chain, pool_tier_t *tier,
+                          void *(*allocate)(size_t), void (*release)(void *));
+
+/**
+ * Allocate from the first tier able to serve size bytes
+ * @param chain
+ * @param size
+ * @return pointer to memory. Null if every tier is exhausted
+ */
+void *pool_chain_allocate(pool_chain_t *chain, size_t size);
+
+/**
+ * Release memory to the tier owning it
+ * @param chain
+ * @param memory
+ */
+void pool_chain_release(pool_chain_t *chain, void *memory);
+
+/**
+ * Find tier owning memory
+ * @param chain
+ * @param memory
+ * @return owning tier, the system tier for memory outside every pool. Null if none
+ */
+pool_tier_t *pool_chain_owner(pool_chain_t *chain, void *memory);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_CHAIN_H
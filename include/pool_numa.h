@@ -0,0 +1,111 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_NUMA_H
+#define MEMORY_POOL_NUMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "block_pool.h"
+#include "byte_pool.h"
+
+#ifndef POOL_NUMA_MAX
+#define POOL_NUMA_MAX 8 /* nodes a pool set can hold */
+#endif
+
+/* pools whose memory lives on one node, either may be Null */
+typedef struct pool_numa_node_t {
+    block_pool_t *block;
+    byte_pool_t  *byte;
+    volatile int byte_lock;     /* byte pools have no lock of their own */
+} pool_numa_node_t;
+
+/**
+ * Pools per NUMA node. Allocation goes to the calling thread's node and
+ * spills to the other nodes in turn once the local pool is exhausted.
+ */
+typedef struct pool_numa_set_t {
+    pool_numa_node_t nodes[POOL_NUMA_MAX];
+    size_t           count;     /* highest node added + 1 */
+    size_t           remote;    /* allocations served by another node's pool */
+} pool_numa_set_t;
+
+/**
+ * Number of NUMA nodes online
+ * @return 1 on machines or platforms without NUMA
+ */
+size_t pool_numa_nodes(void);
+
+/**
+ * Node of the cpu the calling thread runs on
+ * @return node index, 0 without NUMA
+ */
+size_t pool_numa_current(void);
+
+/**
+ * Bind whole pages inside memory to node, migrating pages already touched
+ * @note Bind fresh memory before initializing a pool over it so its metadata
+ *       is first touched on the right node
+ * @param memory
+ * @param size
+ * @param node
+ * @return true if bound. False on single node machines, where memory is left as is
+ */
+int pool_numa_bind(void *memory, size_t size, size_t node);
+
+/**
+ * Prefer node for memory the calling thread touches first from now on
+ * @param node
+ * @return true if set. False on single node machines
+ */
+int pool_numa_prefer(size_t node);
+
+/**
+ * Initialize empty set
+ * @param set
+ */
+void pool_numa_set_init(pool_numa_set_t *set);
+
+/**
+ * Add a node's pools. Their memory is left where it is, bind it to the
+ * node with pool_numa_bind before initializing the pools over it.
+ * Block pools are marked shared, byte pools are only used under the set's lock
+ * @param set
+ * @param node  < POOL_NUMA_MAX
+ * @param block initialized pool or Null
+ * @param byte  initialized pool or Null
+ * @return true if added
+ */
+int pool_numa_set_add(pool_numa_set_t *set, size_t node, block_pool_t *block, byte_pool_t *byte);
+
+/**
+ * Allocate single block, local node first. Release with block_release
+ * @param set
+ * @return pointer to block. Null if every node's block pool is empty
+ */
+void *pool_numa_block_allocate(pool_numa_set_t *set);
+
+/**
+ * Allocate size bytes, local node first. Release with pool_numa_byte_release
+ * @param set
+ * @param size
+ * @return pointer to memory. Null if no node's byte pool can serve size
+ */
+void *pool_numa_byte_allocate(pool_numa_set_t *set, size_t size);
+
+/**
+ * Release memory from pool_numa_byte_allocate under its node's lock
+ * @param set
+ * @param memory    ignored unless it lies in one of the set's byte pools
+ */
+void pool_numa_byte_release(pool_numa_set_t *set, void *memory);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_NUMA_H
@@ -0,0 +1,150 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_PROFILE_H
+#define MEMORY_POOL_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef POOL_PROFILE_DEPTH
+#define POOL_PROFILE_DEPTH 16 /* stack frames kept per allocation site */
+#endif
+
+#ifndef POOL_PROFILE_RATE
+#define POOL_PROFILE_RATE (512 * 1024) /* default mean bytes allocated between samples */
+#endif
+
+typedef struct pool_profile_site_t {
+    uint64_t   hash;                        /* zero while unused */
+    const void *pool;
+    void       *frames[POOL_PROFILE_DEPTH];
+    uint32_t   depth;
+    uint64_t   live_bytes;                  /* estimated bytes allocated here and not yet released */
+    uint64_t   live_count;                  /* sampled allocations not yet released */
+    uint64_t   total_bytes;                 /* estimated bytes ever allocated here */
+} pool_profile_site_t;
+
+typedef struct pool_profile_sample_t {
+    uintptr_t address;                      /* zero while unused, one once removed */
+    uint64_t  weight;                       /* bytes the sample stands for */
+    size_t    site;
+} pool_profile_sample_t;
+
+/**
+ * Sampling heap profile. Every thread counts down bytes allocated from
+ * the pools and records the call stack of the allocation that crosses a
+ * random point, exponentially distributed with mean rate bytes. Samples
+ * are weighted by size / (1 - exp(-size / rate)), the inverse of their
+ * chance of being picked, so live bytes per call site are an unbiased
+ * estimate while the fast path costs a subtraction and a branch.
+ */
+typedef struct pool_profile_t {
+    pool_profile_site_t   *sites;
+    size_t                site_capacity;
+    pool_profile_sample_t *samples;
+    size_t                sample_capacity;
+    size_t                rate;
+    size_t                live;             /* sampled allocations not yet released */
+    size_t                dropped;          /* samples lost to full tables */
+    volatile int          lock;
+} pool_profile_t;
+
+/* bytes left before the calling thread takes its next sample */
+extern __thread int64_t pool_profile_countdown;
+
+/* sampled allocations still live in the attached profile */
+extern volatile size_t pool_profile_live;
+
+/**
+ * Initialize profile
+ * @param profile
+ * @param sites             memory for the call site table
+ * @param site_capacity
+ * @param samples           memory for the live sample table
+ * @param sample_capacity
+ * @param rate              mean bytes between samples, zero for POOL_PROFILE_RATE
+ */
+void pool_profile_init(pool_profile_t *profile, pool_profile_site_t *sites, size_t site_capacity,
+                       pool_profile_sample_t *samples, size_t sample_capacity, size_t rate);
+
+/**
+ * Set the profile pools sample into
+ * @note Pools only sample when the library is built with CPOOL_PROFILE
+ * @param profile   profile to sample into. Null stops sampling
+ */
+void pool_profile_attach(pool_profile_t *profile);
+
+/**
+ * Record allocation in the attached profile, called once the countdown runs out
+ * @param pool
+ * @param address
+ * @param size
+ */
+void pool_profile_sample(const void *pool, const void *address, size_t size);
+
+/**
+ * Forget sampled allocation
+ * @param address
+ */
+void pool_profile_release(const void *address);
+
+/**
+ * Follow sampled allocation to a new address
+ * @param from
+ * @param to
+ */
+void pool_profile_move(const void *from, const void *to);
+
+/**
+ * Copy call sites, most live bytes first
+ * @param profile
+ * @param sites     destination
+ * @param max       max number of sites to copy
+ * @return number of sites copied
+ */
+size_t pool_profile_read(pool_profile_t *profile, pool_profile_site_t *sites, size_t max);
+
+/**
+ * Write a text report of call sites with live memory, most live bytes first
+ * @param profile
+ * @param fd        file descriptor to write to
+ * @return number of sites reported
+ */
+size_t pool_profile_dump(pool_profile_t *profile, int fd);
+
+#ifdef CPOOL_PROFILE
+#define POOL_PROFILE_ALLOCATE(pool, address, size)                                  \
+    do {                                                                            \
+        if ((address) != NULL && (pool_profile_countdown -= (int64_t) (size)) < 0) {\
+            pool_profile_sample(pool, address, size);                               \
+        }                                                                           \
+    } while (0)
+#define POOL_PROFILE_RELEASE(address)                                               \
+    do {                                                                            \
+        if (pool_profile_live > 0) {                                                \
+            pool_profile_release(address);                                          \
+        }                                                                           \
+    } while (0)
+#define POOL_PROFILE_MOVE(from, to)                                                 \
+    do {                                                                            \
+        if (pool_profile_live > 0) {                                                \
+            pool_profile_move(from, to);                                            \
+        }                                                                           \
+    } while (0)
+#else
+#define POOL_PROFILE_ALLOCATE(pool, address, size) ((void) 0)
+#define POOL_PROFILE_RELEASE(address) ((void) 0)
+#define POOL_PROFILE_MOVE(from, to) ((void) 0)
+#endif
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_PROFILE_H
@@ -0,0 +1,80 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_PURGE_H
+#define MEMORY_POOL_PURGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum pool_purge_advice_t {
+    POOL_PURGE_DONTNEED = 0, /* drop pages now, they read back as zero */
+    POOL_PURGE_FREE     = 1, /* let the kernel drop pages under pressure, falls back to DONTNEED */
+} pool_purge_advice_t;
+
+/**
+ * Rate limiting state for returning free pool memory to the OS. Only
+ * page aligned ranges lying wholly inside free memory are purged and pool
+ * metadata is never touched, so pools keep working across purges.
+ * @note Only purge pools over private anonymous memory (heap, stack, bss, mmap)
+ */
+typedef struct pool_purge_t {
+    size_t   page;
+    size_t   threshold;  /* bytes that must be freed since the last purge */
+    uint64_t interval;   /* nanoseconds between purges */
+    uint64_t last;       /* time of the last purge */
+    size_t   watermark;  /* lowest capacity seen since the last purge */
+    size_t   purged;     /* total bytes purged */
+    int      advice;
+} pool_purge_t;
+
+/**
+ * Initialize purge state
+ * @param purge
+ * @param advice    pool_purge_advice_t
+ * @param threshold bytes that must be freed since the last purge before purging again
+ * @param interval  minimum nanoseconds between purges
+ */
+void pool_purge_init(pool_purge_t *purge, int advice, size_t threshold, uint64_t interval);
+
+/**
+ * Check rate limit
+ * @param purge
+ * @return true if interval has passed since the last purge
+ */
+int pool_purge_ready(pool_purge_t *purge);
+
+/**
+ * Check if enough memory was freed to make a purge worthwhile
+ * @param purge
+ * @param capacity  free bytes in the pool now
+ * @return true if capacity grew by threshold over its low point since the last purge
+ */
+int pool_purge_worth(pool_purge_t *purge, size_t capacity);
+
+/**
+ * Purge whole pages inside [start, end)
+ * @param purge
+ * @param start
+ * @param end
+ * @return number of bytes purged
+ */
+size_t pool_purge_range(pool_purge_t *purge, void *start, void *end);
+
+/**
+ * Record a completed purge
+ * @param purge
+ * @param capacity  free bytes in the pool now
+ */
+void pool_purge_done(pool_purge_t *purge, size_t capacity);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_PURGE_H
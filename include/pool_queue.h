@@ -0,0 +1,79 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_QUEUE_H
+#define MEMORY_POOL_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "block_pool.h"
+
+#ifndef POOL_NODE_SIZE
+#define POOL_NODE_SIZE (2 * sizeof(uint64_t)) /* minimum block size of pools feeding containers */
+#endif
+
+#ifndef POOL_QUEUE_CACHE_LINE
+#define POOL_QUEUE_CACHE_LINE 64
+#endif
+
+#if defined(__GNUC__)
+#define POOL_QUEUE_ALIGNED __attribute__((aligned(POOL_QUEUE_CACHE_LINE)))
+#else
+#define POOL_QUEUE_ALIGNED
+#endif
+
+/**
+ * Lock-free multi producer multi consumer FIFO of pointers, a Michael and
+ * Scott queue over block pool nodes. Nodes are recycled inside the queue,
+ * so steady state push and pop never touch the pool or take a lock. Head
+ * and tail sit on separate cache lines so producers and consumers don't
+ * contend.
+ */
+typedef struct pool_queue_t {
+    block_pool_t      *pool;
+    volatile uint64_t free;                         /* tagged link to recycled nodes */
+    volatile uint64_t head POOL_QUEUE_ALIGNED;      /* tagged link to the dummy node */
+    volatile uint64_t tail POOL_QUEUE_ALIGNED;      /* tagged link to the last node */
+} pool_queue_t;
+
+/**
+ * Initialize empty queue, taking one node from pool
+ * @param queue
+ * @param pool      blocks of at least POOL_NODE_SIZE bytes, marked shared
+ */
+void pool_queue_init(pool_queue_t *queue, block_pool_t *pool);
+
+/**
+ * Push value at the tail
+ * @param queue
+ * @param value
+ * @return true if pushed. False if the pool is out of nodes
+ */
+int pool_queue_push(pool_queue_t *queue, void *value);
+
+/**
+ * Pop value from the head
+ * @param queue
+ * @param value     set to the popped value
+ * @return true if popped. False if empty
+ */
+int pool_queue_pop(pool_queue_t *queue, void **value);
+
+/**
+ * Release recycled nodes to the pool
+ * @note Only while no other thread is using the queue
+ * @param queue
+ * @return number of nodes released
+ */
+size_t pool_queue_trim(pool_queue_t *queue);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_QUEUE_H
@@ -0,0 +1,85 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_SHRINK_H
+#define MEMORY_POOL_SHRINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/**
+ * Give memory back to the pool, e.g. by dropping cached objects
+ * @param context   registered with the shrinker
+ * @param target    bytes the pool would like back
+ * @return bytes released to the pool
+ */
+typedef size_t (*pool_shrink_callback_t)(void *context, size_t target);
+
+typedef struct pool_shrinker_t pool_shrinker_t;
+
+/* shrinker registration, storage provided by the caller */
+struct pool_shrinker_t {
+    pool_shrinker_t        *next;
+    pool_shrink_callback_t callback;
+    void                   *context;
+};
+
+/**
+ * Shrinkers a pool calls under memory pressure: when an allocation fails,
+ * after which it retries once, or when free memory drops below the
+ * watermark. Callbacks run without pool locks held, so they may release
+ * into the pool, and one pool never runs its shrinkers twice at once.
+ * @note Register and unregister shrinkers while the pool isn't in use
+ */
+typedef struct pool_shrink_t {
+    pool_shrinker_t *shrinkers;
+    size_t          watermark;  /* free bytes below which shrinkers run, 0 for only on failure */
+    volatile int    running;
+} pool_shrink_t;
+
+/**
+ * Initialize shrinker list
+ * @param shrink
+ */
+void pool_shrink_init(pool_shrink_t *shrink);
+
+/**
+ * Register shrinker, the most recently registered runs first
+ * @param shrink    list of the pool to shrink for
+ * @param shrinker
+ * @param callback
+ * @param context   passed to callback
+ */
+void pool_shrinker_add(pool_shrink_t *shrink, pool_shrinker_t *shrinker, pool_shrink_callback_t callback, void *context);
+
+/**
+ * Unregister shrinker
+ * @param shrink
+ * @param shrinker
+ */
+void pool_shrinker_remove(pool_shrink_t *shrink, pool_shrinker_t *shrinker);
+
+/**
+ * Set low watermark
+ * @param shrink
+ * @param watermark free bytes below which allocations run shrinkers, 0 to only run them on failure
+ */
+void pool_shrink_watermark(pool_shrink_t *shrink, size_t watermark);
+
+/**
+ * Run shrinkers until target bytes are released or every shrinker has run
+ * @param shrink
+ * @param target
+ * @return bytes released. 0 if none or if shrinkers are already running
+ */
+size_t pool_shrink(pool_shrink_t *shrink, size_t target);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_SHRINK_H
@@ -0,0 +1,66 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_STACK_H
+#define MEMORY_POOL_STACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "block_pool.h"
+
+#ifndef POOL_NODE_SIZE
+#define POOL_NODE_SIZE (2 * sizeof(uint64_t)) /* minimum block size of pools feeding containers */
+#endif
+
+/**
+ * Lock-free LIFO of pointers. Nodes come from a block pool and are
+ * recycled inside the stack, so steady state push and pop never touch
+ * the pool or take a lock.
+ */
+typedef struct pool_stack_t {
+    block_pool_t      *pool;
+    volatile uint64_t top;      /* tagged link to the top node */
+    volatile uint64_t free;     /* tagged link to recycled nodes */
+} pool_stack_t;
+
+/**
+ * Initialize empty stack
+ * @param stack
+ * @param pool      blocks of at least POOL_NODE_SIZE bytes, marked shared
+ */
+void pool_stack_init(pool_stack_t *stack, block_pool_t *pool);
+
+/**
+ * Push value
+ * @param stack
+ * @param value
+ * @return true if pushed. False if the pool is out of nodes
+ */
+int pool_stack_push(pool_stack_t *stack, void *value);
+
+/**
+ * Pop most recently pushed value
+ * @param stack
+ * @param value     set to the popped value
+ * @return true if popped. False if empty
+ */
+int pool_stack_pop(pool_stack_t *stack, void **value);
+
+/**
+ * Release recycled nodes to the pool
+ * @note Only while no other thread is using the stack
+ * @param stack
+ * @return number of nodes released
+ */
+size_t pool_stack_trim(pool_stack_t *stack);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_STACK_H
@@ -0,0 +1,111 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_TRACE_H
+#define MEMORY_POOL_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_TRACE_MAGIC   "CPOOLTRC"
+#define POOL_TRACE_VERSION 1
+
+typedef enum pool_trace_type_t {
+    POOL_TRACE_ALLOCATE = 1, /* size requested, address returned (0 on failure) */
+    POOL_TRACE_RELEASE  = 2, /* size of the released block */
+    POOL_TRACE_SIZE     = 3, /* size reported for address */
+} pool_trace_type_t;
+
+typedef struct pool_trace_event_t {
+    uint64_t timestamp; /* monotonic nanoseconds */
+    uint64_t pool;      /* pool id, the address of the pool */
+    uint64_t address;
+    uint32_t size;
+    uint32_t type;
+} pool_trace_event_t;
+
+typedef struct pool_trace_file_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t event_size;
+    uint64_t count;
+} pool_trace_file_t;
+
+typedef struct pool_trace_t {
+    pool_trace_event_t *events;
+    size_t             capacity;
+    volatile size_t    head;
+} pool_trace_t;
+
+/**
+ * Initialize trace ring buffer
+ * @note Oldest events are overwritten once the buffer is full
+ * @param trace
+ * @param buffer    memory to store events in
+ * @param size      size of buffer in bytes
+ */
+void pool_trace_init(pool_trace_t *trace, void *buffer, size_t size);
+
+/**
+ * Set the trace pools record their events into
+ * @note Pools only emit events when the library is built with CPOOL_TRACE
+ * @param trace     trace to record into. Null stops recording
+ */
+void pool_trace_attach(pool_trace_t *trace);
+
+/**
+ * Record single event, safe to call from multiple threads
+ * @param trace
+ * @param type      pool_trace_type_t
+ * @param pool      pool the event happened on
+ * @param address   block address
+ * @param size      number of bytes
+ */
+void pool_trace_record(pool_trace_t *trace, uint32_t type, const void *pool, const void *address, size_t size);
+
+/**
+ * Record single event into the attached trace if there is one
+ */
+void pool_trace_emit(uint32_t type, const void *pool, const void *address, size_t size);
+
+/**
+ * Number of events currently held by the trace
+ * @param trace
+ * @return
+ */
+size_t pool_trace_count(pool_trace_t *trace);
+
+/**
+ * Copy held events oldest first
+ * @note Take snapshots while no events are being recorded
+ * @param trace
+ * @param events    destination
+ * @param max       max number of events to copy
+ * @return number of events copied
+ */
+size_t pool_trace_read(pool_trace_t *trace, pool_trace_event_t *events, size_t max);
+
+/**
+ * Write held events to a file readable by cpool_replay
+ * @param trace
+ * @param path
+ * @return number of events written. Zero on failure
+ */
+size_t pool_trace_save(pool_trace_t *trace, const char *path);
+
+#ifdef CPOOL_TRACE
+#define POOL_TRACE(type, pool, address, size) pool_trace_emit(type, pool, address, size)
+#else
+#define POOL_TRACE(type, pool, address, size) ((void) 0)
+#endif
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_POOL_TRACE_H
@@ -0,0 +1,130 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_REGION_POOL_H
+#define MEMORY_REGION_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "byte_pool.h"
+#include "segment_pool.h"
+
+#ifndef REGION_ALIGNMENT
+#define REGION_ALIGNMENT sizeof(void *) /* every allocation is rounded up to this */
+#endif
+
+typedef enum region_source_type_t {
+    REGION_SOURCE_NONE,
+    REGION_SOURCE_SEGMENT,
+    REGION_SOURCE_BYTE,
+} region_source_type_t;
+
+typedef struct region_chunk_t region_chunk_t;
+
+/* header at the start of every chunk, chunks stay linked after a rewind for reuse */
+struct region_chunk_t {
+    region_chunk_t *next;
+    char           *end;
+    size_t         size;        /* bytes taken from the source, 0 for caller memory */
+};
+
+/**
+ * Bump pointer allocator over a list of chunks. Allocations carry no
+ * header and are never released on their own, memory is given back all
+ * at once by rewinding to a mark or resetting the region.
+ */
+typedef struct region_pool_t {
+    region_chunk_t *first;
+    region_chunk_t *chunk;      /* chunk being allocated from */
+    char           *top;        /* next free byte in chunk */
+    char           *end;
+    int            source;      /* region_source_type_t */
+    void           *pool;       /* segment_pool_t or byte_pool_t chunks come from */
+    size_t         chunk_size;  /* bytes requested from a byte pool per chunk */
+} region_pool_t;
+
+/* position in a region to rewind to */
+typedef struct region_mark_t {
+    region_chunk_t *chunk;
+    char           *top;
+} region_mark_t;
+
+/**
+ * Initialize region
+ * @param region
+ * @param memory    first chunk, may be Null to take every chunk from a source
+ * @param size      bytes of memory
+ */
+void region_pool_init(region_pool_t *region, void *memory, size_t size);
+
+/**
+ * Take further chunks from a segment pool, one segment at a time or a
+ * run of segments for allocations larger than one
+ * @param region
+ * @param pool      alignment > sizeof(region_chunk_t)
+ */
+void region_pool_segment_source(region_pool_t *region, segment_pool_t *pool);
+
+/**
+ * Take further chunks from a byte pool
+ * @param region
+ * @param pool
+ * @param chunk_size    bytes per chunk, rounded up to whole byte pool headers.
+ *                      Larger allocations get a chunk of their own
+ */
+void region_pool_byte_source(region_pool_t *region, byte_pool_t *pool, size_t chunk_size);
+
+int region_pool_is_valid(region_pool_t *region);
+
+/**
+ * Allocate from the current chunk, moving to the next one when it is full
+ * @param region
+ * @param size
+ * @return pointer to memory aligned to REGION_ALIGNMENT. Null if no chunk fits
+ */
+void *region_allocate(region_pool_t *region, size_t size);
+
+/**
+ * Record the current position
+ * @param region
+ * @return mark for region_rewind
+ */
+region_mark_t region_mark(region_pool_t *region);
+
+/**
+ * Drop every allocation made since mark was taken. Chunks past the mark
+ * are kept for reuse rather than returned to the source
+ * @param region
+ * @param mark      taken from region and not yet rewound past
+ */
+void region_rewind(region_pool_t *region, region_mark_t mark);
+
+/**
+ * Drop every allocation, keeping all chunks
+ * @param region
+ */
+void region_reset(region_pool_t *region);
+
+/**
+ * Return chunks past the current one to their source
+ * @param region
+ * @return number of bytes returned
+ */
+size_t region_pool_trim(region_pool_t *region);
+
+/**
+ * Drop every allocation and return every chunk taken from the source
+ * @param region
+ * @return number of bytes returned
+ */
+size_t region_pool_release(region_pool_t *region);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_REGION_POOL_H
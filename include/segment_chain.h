@@ -0,0 +1,78 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_SEGMENT_CHAIN_H
+#define MEMORY_SEGMENT_CHAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "segment_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#else
+struct iovec {
+    void   *iov_base;
+    size_t iov_len;
+};
+#endif
+
+/* bytes at the start of every chained segment holding its link and reference count */
+#define SEGMENT_CHAIN_HEADER (2 * sizeof(void *))
+
+typedef struct segment_link_t segment_link_t;
+
+/**
+ * Byte range over a chain of segments. Segments need not be contiguous,
+ * each carries a reference count so slices of one buffer can be shared
+ * and released independently without copying.
+ */
+typedef struct segment_slice_t {
+    segment_pool_t *pool;
+    segment_link_t *first;      /* segment holding offset */
+    size_t         offset;      /* into first's payload */
+    size_t         length;
+} segment_slice_t;
+
+/**
+ * Allocate size bytes as a chain of single segments
+ * @param pool      alignment > SEGMENT_CHAIN_HEADER
+ * @param slice     set to the whole chain
+ * @param size
+ * @return true if allocated. On failure nothing is held and slice is empty
+ */
+int segment_chain_allocate(segment_pool_t *pool, segment_slice_t *slice, size_t size);
+
+/**
+ * Describe slice for readv or writev
+ * @param slice
+ * @param iov
+ * @param count     number of entries in iov
+ * @return entries filled, at most count
+ */
+int segment_chain_iovec(const segment_slice_t *slice, struct iovec *iov, int count);
+
+/**
+ * Share part of a slice, taking a reference on each segment it covers
+ * @param slice     set to the shared range
+ * @param source
+ * @param offset    into source
+ * @param length    clamped to the end of source
+ */
+void segment_chain_share(segment_slice_t *slice, const segment_slice_t *source, size_t offset, size_t length);
+
+/**
+ * Drop slice's references, releasing segments no other slice covers
+ * @param slice     emptied
+ */
+void segment_chain_release(segment_slice_t *slice);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_SEGMENT_CHAIN_H
@@ -11,6 +11,8 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
+#include "pool_purge.h"
 
 typedef struct segment_pool_t segment_pool_t;
 
@@ -19,6 +21,12 @@ struct segment_pool_t {
     void *search;
     void *end;
     size_t alignment;
+    volatile int      lock;
+    volatile uint32_t waiters;
+    volatile uint32_t wake;     /* futex word, bumped by releases while callers wait */
+    void *untouched;            /* segments from here on have never been handed out */
+    int zeroed;                 /* untouched segments read as zero past their link word */
+    int shared;                 /* used from several threads, operations take the lock */
 };
 
 /**
@@ -37,6 +45,37 @@ void segment_pool_init(segment_pool_t *pool, size_t alignment, void *start, void
  */
 void *segment_allocate(segment_pool_t *pool);
 
+/**
+ * Allocate single segment cleared to zero. Segments never handed out
+ * only get their link word cleared if the pool was marked zeroed
+ * @param pool
+ * @return pointer to segment. Null if pool is empty
+ */
+void *segment_allocate_zeroed(segment_pool_t *pool);
+
+/**
+ * Declare pool memory that hasn't been handed out yet to read as zero,
+ * e.g. fresh mmap or bss memory, so zeroed allocations skip clearing it
+ * @param pool
+ */
+void segment_pool_mark_zeroed(segment_pool_t *pool);
+
+/**
+ * Declare pool shared between threads. Only shared pools take the pool
+ * lock, pools used from a single thread allocate and release without atomics
+ * @param pool
+ */
+void segment_pool_mark_shared(segment_pool_t *pool);
+
+/**
+ * Allocate single segment, parking the caller until one is released if the pool is empty
+ * @note Only shared pools wait, anything else returns at once as no other thread can release
+ * @param pool
+ * @param timeout   nanoseconds to wait, UINT64_MAX waits forever
+ * @return pointer to segment. Null if none was released within timeout
+ */
+void *segment_allocate_wait(segment_pool_t *pool, uint64_t timeout);
+
 /**
  * Unordered release of single segment
  * @param pool
@@ -62,7 +101,7 @@ void *segment_allocate_size(segment_pool_t *pool, size_t size);
 
 /**
  * Unordered release of custom sized segments
- * @note    Worse defragmentation than ordered release
+ * @note    Worse defragmentation than ordered release. Wakes a waiting caller per segment
  * @param pool      original owner of the memory
  * @param memory    memory to release
  * @param size      size of memory segment
@@ -78,6 +117,18 @@ void segment_release_size(segment_pool_t *pool, void *memory, size_t size);
  */
 void segment_ordered_release_size(segment_pool_t *pool, void *memory, size_t size);
 
+/**
+ * Return whole pages inside runs of neighbouring free segments to the OS
+ * @note    Sorts the free list by address. Each purged run keeps only its
+ *          first two words resident, its links are rebuilt one segment at a
+ *          time as it is allocated again. The purge threshold is ignored
+ *          since the pool doesn't track its capacity
+ * @param pool
+ * @param purge     rate limit, skipped until its interval is met
+ * @return number of bytes purged
+ */
+size_t segment_pool_purge(segment_pool_t *pool, pool_purge_t *purge);
+
 /**
  * Check if pool is empty
  * @param pool
@@ -0,0 +1,106 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_SHARD_POOL_H
+#define MEMORY_SHARD_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "segment_pool.h"
+
+#ifndef SHARD_POOL_BATCH
+#define SHARD_POOL_BATCH 32 /* segments moved between a shard and the global pool at once */
+#endif
+
+#ifndef SHARD_CACHE_LINE
+#define SHARD_CACHE_LINE 64
+#endif
+
+#if defined(__GNUC__)
+#define SHARD_ALIGNED __attribute__((aligned(SHARD_CACHE_LINE)))
+#else
+#define SHARD_ALIGNED
+#endif
+
+typedef struct shard_t shard_t;
+
+typedef struct shard_pool_t shard_pool_t;
+
+/**
+ * Per-cpu cache of free segments. Padded to a cache line so neighbouring
+ * shards don't false share.
+ */
+struct shard_t {
+    segment_pool_t cache;
+    size_t         count;
+    int            active;
+    volatile int   lock;
+} SHARD_ALIGNED;
+
+struct shard_pool_t {
+    segment_pool_t global;
+    shard_t        *shards;
+    size_t         shard_count;
+    size_t         batch;
+    volatile int   lock;
+};
+
+/**
+ * Initialize sharded segment pool
+ * @param pool
+ * @param shards        caller owned array of shards, normally one per cpu
+ * @param shard_count   number of elements in shards
+ * @param alignment     segment size >= sizeof(void*)
+ * @param start
+ * @param end
+ */
+void shard_pool_init(shard_pool_t *pool, shard_t *shards, size_t shard_count, size_t alignment, void *start, void *end);
+
+/**
+ * Allocate single segment from the calling cpu's shard
+ * @note Refills the shard from the global pool in batches when it runs dry
+ * @param pool
+ * @return pointer to segment. Null if pool is exhausted
+ */
+void *shard_allocate(shard_pool_t *pool);
+
+/**
+ * Release single segment to the calling cpu's shard
+ * @note Hands a batch back to the global pool when the shard holds too many
+ * @param pool      original owner of the memory
+ * @param memory    memory to release
+ */
+void shard_release(shard_pool_t *pool, void *memory);
+
+/**
+ * Index of the shard serving the calling cpu
+ * @param pool
+ * @return shard index < pool->shard_count
+ */
+size_t shard_pool_current(shard_pool_t *pool);
+
+/**
+ * Return every cached segment of a shard to the global pool
+ * @param pool
+ * @param shard index of shard to drain
+ * @return number of segments returned
+ */
+size_t shard_pool_drain(shard_pool_t *pool, size_t shard);
+
+/**
+ * Drain shards that have been idle since the previous trim
+ * @note Call periodically to let idle cpus give their memory back
+ * @param pool
+ * @return number of segments returned
+ */
+size_t shard_pool_trim(shard_pool_t *pool);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //MEMORY_SHARD_POOL_H
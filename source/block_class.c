@@ -0,0 +1,283 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "block_class.h"
+#include "pool_sync.h"
+#include <stdbool.h>
+
+static block_pool_t *block_class_owner(block_class_pool_t *classes, void *memory, size_t *index);
+
+static bool block_class_rebuild(block_class_pool_t *classes, size_t index);
+
+static size_t block_class_plan(block_class_pool_t *classes, const uint32_t *counts, size_t *sizes, uint64_t *demand);
+
+void block_class_init(block_class_pool_t *classes, block_pool_t *pools, size_t count, size_t granule) {
+    if (classes != NULL && pools != NULL && count > 0 && count <= BLOCK_CLASS_MAX
+        && granule > 0 && granule % sizeof(void *) == 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (!block_pool_is_valid(&pools[i])) {
+                return;
+            }
+        }
+
+        classes->pools   = pools;
+        classes->count   = count;
+        classes->granule = granule;
+        classes->lock    = 0;
+        for (size_t i = 0; i < BLOCK_CLASS_MAX; i++) {
+            classes->planned[i] = 0;
+        }
+        for (size_t i = 0; i < BLOCK_CLASS_BUCKETS; i++) {
+            classes->histogram[i] = 0;
+        }
+    }
+}
+
+int block_class_pool_is_valid(block_class_pool_t *classes) {
+    return (classes != NULL)
+           && (classes->pools != NULL)
+           && (classes->count > 0)
+           && (classes->count <= BLOCK_CLASS_MAX)
+           && (classes->granule > 0);
+}
+
+void *block_class_allocate(block_class_pool_t *classes, size_t size) {
+    void         *block = NULL;
+    block_pool_t *pool;
+    size_t       bucket;
+    size_t       best;
+    uint32_t     tried = 0;
+
+    if (!block_class_pool_is_valid(classes) || size == 0) {
+        return NULL;
+    }
+
+    bucket = (size - 1) / classes->granule;
+    if (bucket < BLOCK_CLASS_BUCKETS) {
+        __atomic_fetch_add(&classes->histogram[bucket], 1, __ATOMIC_RELAXED);
+    }
+
+    /* try fitting classes smallest first, pools are in no particular order */
+    for (size_t attempt = 0; attempt < classes->count && block == NULL; attempt++) {
+        best = classes->count;
+        for (size_t i = 0; i < classes->count; i++) {
+            pool = &classes->pools[i];
+            if (pool->alignment < size || pool->available == 0 || (tried & (1u << i))) {
+                continue;
+            }
+            if (best == classes->count || pool->alignment < classes->pools[best].alignment) {
+                best = i;
+            }
+        }
+
+        if (best == classes->count) {
+            break;
+        }
+
+        pool   = &classes->pools[best];
+        tried |= 1u << best;
+        block  = block_allocate(pool);
+
+        /* an emptied pool may have been rebuilt smaller since it was picked */
+        if (block != NULL && pool->alignment < size) {
+            block_release(block);
+            block = NULL;
+        }
+    }
+
+    return block;
+}
+
+void block_class_release(block_class_pool_t *classes, void *memory) {
+    block_pool_t *pool;
+    size_t       index;
+
+    if (block_class_pool_is_valid(classes) && (pool = block_class_owner(classes, memory, &index)) != NULL) {
+        block_release(memory);
+        if (pool->available == pool->capacity) {
+            block_class_rebuild(classes, index);
+        }
+    }
+}
+
+size_t block_class_tune(block_class_pool_t *classes) {
+    uint32_t counts[BLOCK_CLASS_BUCKETS];
+    size_t   sizes[BLOCK_CLASS_MAX];
+    uint64_t demand[BLOCK_CLASS_MAX];
+    size_t   order[BLOCK_CLASS_MAX];
+    size_t   rank[BLOCK_CLASS_MAX];
+    size_t   classes_used;
+    size_t   rebuilt = 0;
+    size_t   swap;
+
+    if (!block_class_pool_is_valid(classes)) {
+        return 0;
+    }
+
+    pool_lock(&classes->lock);
+
+    /* snapshot the histogram and halve it, keeping requests counted since */
+    for (size_t i = 0; i < BLOCK_CLASS_BUCKETS; i++) {
+        counts[i] = __atomic_load_n(&classes->histogram[i], __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&classes->histogram[i], counts[i] - counts[i] / 2, __ATOMIC_RELAXED);
+    }
+
+    classes_used = block_class_plan(classes, counts, sizes, demand);
+    if (classes_used > 0) {
+        /* pools by memory, largest first, and classes by bytes requested, most first */
+        for (size_t i = 0; i < classes->count; i++) {
+            order[i] = i;
+            rank[i]  = i;
+        }
+        for (size_t i = 1; i < classes->count; i++) {
+            for (size_t j = i; j > 0 && (classes->pools[order[j]].end - classes->pools[order[j]].start)
+                                        > (classes->pools[order[j - 1]].end - classes->pools[order[j - 1]].start); j--) {
+                swap = order[j], order[j] = order[j - 1], order[j - 1] = swap;
+            }
+        }
+        for (size_t i = 1; i < classes_used; i++) {
+            for (size_t j = i; j > 0 && demand[rank[j]] > demand[rank[j - 1]]; j--) {
+                swap = rank[j], rank[j] = rank[j - 1], rank[j - 1] = swap;
+            }
+        }
+
+        /* pools beyond the number of classes add blocks to the busiest classes */
+        for (size_t i = 0; i < classes->count; i++) {
+            classes->planned[order[i]] = sizes[rank[i % classes_used]];
+        }
+    }
+
+    pool_unlock(&classes->lock);
+
+    for (size_t i = 0; i < classes->count; i++) {
+        if (block_class_rebuild(classes, i)) {
+            rebuilt++;
+        }
+    }
+
+    return rebuilt;
+}
+
+uint64_t block_class_waste(block_class_pool_t *classes, const size_t *sizes) {
+    uint64_t waste = 0;
+    size_t   top;
+    size_t   best;
+    size_t   size;
+
+    if (!block_class_pool_is_valid(classes)) {
+        return 0;
+    }
+
+    for (size_t bucket = 0; bucket < BLOCK_CLASS_BUCKETS; bucket++) {
+        top  = (bucket + 1) * classes->granule;
+        best = 0;
+        for (size_t i = 0; i < classes->count; i++) {
+            size = (sizes != NULL) ? sizes[i] : classes->pools[i].alignment;
+            if (size >= top && (best == 0 || size < best)) {
+                best = size;
+            }
+        }
+        if (best > 0) {
+            waste += (uint64_t) __atomic_load_n(&classes->histogram[bucket], __ATOMIC_RELAXED) * (best - top);
+        }
+    }
+
+    return waste;
+}
+
+static block_pool_t *block_class_owner(block_class_pool_t *classes, void *memory, size_t *index) {
+    for (size_t i = 0; i < classes->count; i++) {
+        if (memory > classes->pools[i].start && memory < classes->pools[i].end) {
+            *index = i;
+            return &classes->pools[i];
+        }
+    }
+    return NULL;
+}
+
+/* move an empty pool to its planned size, reset leaves the pool alone if a block went out meanwhile */
+static bool block_class_rebuild(block_class_pool_t *classes, size_t index) {
+    block_pool_t *pool    = &classes->pools[index];
+    size_t       planned = __atomic_load_n(&classes->planned[index], __ATOMIC_RELAXED);
+
+    if (planned == 0 || planned == pool->alignment || pool->available != pool->capacity) {
+        return false;
+    }
+
+    block_pool_reset(pool, planned);
+    return pool->alignment == planned;
+}
+
+/*
+ * Class sizes minimizing waste for the counted requests, by dynamic
+ * programming over the buckets that saw requests. A class serves every
+ * bucket after the previous class up to its own, so its cost is
+ * size * requests - requested bytes over that range, from prefix sums.
+ */
+static size_t block_class_plan(block_class_pool_t *classes, const uint32_t *counts, size_t *sizes, uint64_t *demand) {
+    uint16_t bucket[BLOCK_CLASS_BUCKETS];
+    uint64_t requests[BLOCK_CLASS_BUCKETS + 1];
+    uint64_t bytes[BLOCK_CLASS_BUCKETS + 1];
+    uint64_t cost[2][BLOCK_CLASS_BUCKETS];
+    uint16_t split[BLOCK_CLASS_MAX][BLOCK_CLASS_BUCKETS];
+    uint64_t *previous, *current, total, top;
+    size_t   used = 0;
+    size_t   k;
+    size_t   last;
+
+    requests[0] = 0;
+    bytes[0]    = 0;
+    for (size_t i = 0; i < BLOCK_CLASS_BUCKETS; i++) {
+        if (counts[i] > 0) {
+            top                = (i + 1) * classes->granule;
+            bucket[used]       = (uint16_t) i;
+            requests[used + 1] = requests[used] + counts[i];
+            bytes[used + 1]    = bytes[used] + counts[i] * top;
+            used++;
+        }
+    }
+
+    if (used == 0) {
+        return 0;
+    }
+    k = (classes->count < used) ? classes->count : used;
+
+    /* cost[t] is the least waste serving buckets 0..t with the last class at bucket t */
+    previous = cost[0];
+    current  = cost[1];
+    for (size_t t = 0; t < used; t++) {
+        top         = (bucket[t] + 1) * classes->granule;
+        previous[t] = top * requests[t + 1] - bytes[t + 1];
+        split[0][t] = 0;
+    }
+
+    for (size_t c = 1; c < k; c++) {
+        for (size_t t = 0; t < used; t++) {
+            top        = (bucket[t] + 1) * classes->granule;
+            current[t] = UINT64_MAX;
+            for (size_t i = c; i <= t; i++) {
+                /* previous class ends at bucket i - 1, this one serves i..t */
+                total = previous[i - 1] + top * (requests[t + 1] - requests[i]) - (bytes[t + 1] - bytes[i]);
+                if (previous[i - 1] != UINT64_MAX && total < current[t]) {
+                    current[t]  = total;
+                    split[c][t] = (uint16_t) i;
+                }
+            }
+        }
+        previous = current;
+        current  = (current == cost[0]) ? cost[1] : cost[0];
+    }
+
+    /* walk the splits back from a class at the largest bucket */
+    last = used - 1;
+    for (size_t c = k; c-- > 0;) {
+        size_t first = (c > 0) ? split[c][last] : 0;
+
+        sizes[c]  = (bucket[last] + 1) * classes->granule;
+        demand[c] = (requests[last + 1] - requests[first]) * sizes[c];
+        last      = first - 1;
+    }
+
+    return k;
+}
@@ -0,0 +1,127 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "block_epoch.h"
+#include "pool_sync.h"
+#include <stdbool.h>
+
+#define BLOCK_EPOCH_ACTIVE 1u
+
+static bool block_epoch_advance(block_epoch_t *domain);
+
+static size_t block_epoch_reclaim(block_epoch_t *domain, block_epoch_record_t *record, size_t list);
+
+void block_epoch_init(block_epoch_t *domain, block_pool_t *pool) {
+    if (domain != NULL && block_pool_is_valid(pool)) {
+        domain->pool    = pool;
+        domain->records = NULL;
+        domain->epoch   = 0;
+        block_pool_mark_shared(pool); /* every registered thread releases into it */
+    }
+}
+
+void block_epoch_register(block_epoch_t *domain, block_epoch_record_t *record) {
+    if (domain != NULL && record != NULL) {
+        record->state = 0;
+        record->count = 0;
+        for (size_t i = 0; i < 3; i++) {
+            record->retired[i] = NULL;
+            record->epoch[i]   = 0;
+        }
+
+        record->next = __atomic_load_n(&domain->records, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&domain->records, &record->next, record, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+}
+
+void block_epoch_enter(block_epoch_t *domain, block_epoch_record_t *record) {
+    uint64_t epoch;
+
+    /* publish the epoch, then confirm it is still current so an advance can't slip past us */
+    do {
+        epoch = __atomic_load_n(&domain->epoch, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&record->state, epoch << 1 | BLOCK_EPOCH_ACTIVE, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    } while (__atomic_load_n(&domain->epoch, __ATOMIC_RELAXED) != epoch);
+}
+
+void block_epoch_exit(block_epoch_record_t *record) {
+    __atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+}
+
+void block_epoch_retire(block_epoch_t *domain, block_epoch_record_t *record, void *block) {
+    uint64_t epoch;
+    size_t   list;
+
+    if (domain != NULL && record != NULL && block != NULL) {
+        epoch = __atomic_load_n(&domain->epoch, __ATOMIC_ACQUIRE);
+        list  = epoch % 3;
+
+        /* a list from an older epoch sharing the slot is at least three epochs old */
+        if (record->retired[list] != NULL && record->epoch[list] != epoch) {
+            block_epoch_reclaim(domain, record, list);
+        }
+
+        record->retired[list] = block_list_push(record->retired[list], block);
+        record->epoch[list]   = epoch;
+        record->count++;
+
+        if (record->count >= BLOCK_EPOCH_BATCH) {
+            block_epoch_poll(domain, record);
+        }
+    }
+}
+
+size_t block_epoch_poll(block_epoch_t *domain, block_epoch_record_t *record) {
+    size_t   released = 0;
+    uint64_t epoch;
+
+    if (domain != NULL && record != NULL) {
+        block_epoch_advance(domain);
+        epoch = __atomic_load_n(&domain->epoch, __ATOMIC_ACQUIRE);
+
+        for (size_t list = 0; list < 3; list++) {
+            if (record->retired[list] != NULL && record->epoch[list] + 2 <= epoch) {
+                released += block_epoch_reclaim(domain, record, list);
+            }
+        }
+    }
+
+    return released;
+}
+
+void block_epoch_synchronize(block_epoch_t *domain, block_epoch_record_t *record) {
+    if (domain != NULL && record != NULL) {
+        while (block_epoch_poll(domain, record), record->count > 0) {
+            POOL_SYNC_YIELD();
+        }
+    }
+}
+
+/* move the epoch on if every thread inside a critical section has seen the current one */
+static bool block_epoch_advance(block_epoch_t *domain) {
+    uint64_t             epoch = __atomic_load_n(&domain->epoch, __ATOMIC_ACQUIRE);
+    uint64_t             state;
+    block_epoch_record_t *record;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (record = __atomic_load_n(&domain->records, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+        state = __atomic_load_n(&record->state, __ATOMIC_ACQUIRE);
+        if ((state & BLOCK_EPOCH_ACTIVE) && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+
+    return __atomic_compare_exchange_n(&domain->epoch, &epoch, epoch + 1, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static size_t block_epoch_reclaim(block_epoch_t *domain, block_epoch_record_t *record, size_t list) {
+    size_t released = block_release_list(domain->pool, record->retired[list]);
+
+    record->retired[list] = NULL;
+    record->count        -= released;
+    return released;
+}
@@ -4,6 +4,10 @@
 
 #include <stddef.h>
 #include "block_pool.h"
+#include "pool_probe.h"
+#include "pool_profile.h"
+#include "pool_sync.h"
+#include "pool_zero.h"
 
 typedef union block_header_t block_header_t;
 
@@ -12,6 +16,10 @@ union block_header_t {
     block_pool_t   *owner;
 };
 
+static void *block_pool_allocate(block_pool_t *pool, void **untouched);
+
+static void *block_pool_take(block_pool_t *pool);
+
 void block_pool_init(block_pool_t *pool, size_t alignment, void *start, void *end) {
     if (pool != NULL && alignment > 0 && start != NULL && end != NULL) {
         if ((end - start) > sizeof(block_header_t) + alignment) {
@@ -21,6 +29,13 @@ void block_pool_init(block_pool_t *pool, size_t alignment, void *start, void *en
             pool->alignment = alignment;
             pool->capacity  = 0;
             pool->available = 0;
+            pool->lock      = 0;
+            pool->waiters   = 0;
+            pool->wake      = 0;
+            pool->untouched = start;
+            pool->zeroed    = 0;
+            pool->shared    = 0;
+            pool_shrink_init(&pool->shrink);
 
             block_pool_reset(pool, pool->alignment);
         }
@@ -37,9 +52,15 @@ int block_pool_is_valid(block_pool_t *pool) {
 
 void block_pool_reset(block_pool_t *pool, size_t alignment) {
     block_header_t *block;
-    if (block_pool_is_valid(pool)) {
+    if (block_pool_is_valid(pool) && alignment > 0) {
+        pool_lock_shared(&pool->lock, pool->shared);
         if (pool->available == pool->capacity) {
+            if (alignment != pool->alignment) {
+                pool->untouched = pool->end;
+            }
             pool->alignment = alignment;
+            pool->search    = pool->start;
+            pool->capacity  = 0;
 
             /* initialize memory into a stack where each element points to the next element*/
             for (block = pool->search; (void *) (block + 1) + alignment < pool->end; block = block->next) {
@@ -53,19 +74,66 @@ void block_pool_reset(block_pool_t *pool, size_t alignment) {
             /* set all blocks available */
             pool->available = pool->capacity;
         }
+        pool_unlock_shared(&pool->lock, pool->shared);
     }
 }
 
 void *block_allocate(block_pool_t *pool) {
-    block_header_t *block = NULL;
+    void *untouched;
+    void *block = block_pool_allocate(pool, &untouched);
+
+    POOL_PROFILE_ALLOCATE(pool, block, pool->alignment);
+    return block;
+}
+
+void *block_allocate_zeroed(block_pool_t *pool) {
+    void *untouched;
+    void *block = block_pool_allocate(pool, &untouched);
+
+    if (block != NULL) {
+        pool_zero_used(block, pool->alignment, untouched, pool->zeroed);
+        POOL_PROFILE_ALLOCATE(pool, block, pool->alignment);
+    }
+    return block;
+}
+
+void block_pool_mark_zeroed(block_pool_t *pool) {
     if (block_pool_is_valid(pool)) {
-        if (pool->search != NULL && pool->available > 0) {
-            block = pool->search;
-            pool->search = block->next;
-            block->owner = pool;
-            pool->available--;
-            block = block + 1; /* move block ptr to user space */
+        pool->zeroed = 1;
+    }
+}
+
+void block_pool_mark_shared(block_pool_t *pool) {
+    if (block_pool_is_valid(pool)) {
+        pool->shared = 1;
+    }
+}
+
+void *block_allocate_wait(block_pool_t *pool, uint64_t timeout) {
+    void     *block = NULL;
+    uint64_t deadline;
+    uint64_t now;
+    uint32_t wake;
+
+    if (block_pool_is_valid(pool)) {
+        /* nothing can release into a pool used from one thread, so only try once */
+        deadline = pool->shared ? pool_deadline(timeout) : 0;
+
+        pool_lock_shared(&pool->lock, pool->shared);
+        while ((block = block_pool_take(pool)) == NULL && (now = pool_clock()) < deadline) {
+            /* sample the futex word under the lock so a release after unlocking isn't missed */
+            pool->waiters++;
+            wake = pool->wake;
+            pool_unlock_shared(&pool->lock, pool->shared);
+
+            pool_wait(&pool->wake, wake, deadline - now);
+
+            pool_lock_shared(&pool->lock, pool->shared);
+            pool->waiters--;
         }
+        pool_unlock_shared(&pool->lock, pool->shared);
+        POOL_PROBE3(block_allocate, pool, block, pool->alignment);
+        POOL_PROFILE_ALLOCATE(pool, block, pool->alignment);
     }
     return block;
 }
@@ -73,6 +141,7 @@ void *block_allocate(block_pool_t *pool) {
 void block_release(void *memory) {
     block_header_t *block;
     block_pool_t   *pool;
+    uint32_t       wake = 0;
 
     if (memory != NULL) {
         /* get block ptr */
@@ -80,9 +149,112 @@ void block_release(void *memory) {
         pool  = block->owner;
 
         if (block_pool_is_valid(pool)) {
+            POOL_PROBE2(block_release, pool, memory);
+            POOL_PROFILE_RELEASE(memory);
+
+            pool_lock_shared(&pool->lock, pool->shared);
             block->next  = pool->search;
             pool->search = block;
             pool->available++;
+            if (pool->waiters > 0) {
+                pool->wake++;
+                wake = 1;
+            }
+            pool_unlock_shared(&pool->lock, pool->shared);
+
+            if (wake > 0) {
+                pool_wake(&pool->wake, wake);
+            }
+        }
+    }
+}
+
+void *block_list_push(void *list, void *memory) {
+    block_header_t *block;
+
+    if (memory != NULL) {
+        block       = ((block_header_t *) memory) - 1;
+        block->next = (list != NULL) ? ((block_header_t *) list) - 1 : NULL;
+        list        = memory;
+    }
+    return list;
+}
+
+size_t block_release_list(block_pool_t *pool, void *list) {
+    block_header_t *first;
+    block_header_t *last;
+    size_t         count = 0;
+    uint32_t       wake  = 0;
+
+    if (block_pool_is_valid(pool) && list != NULL) {
+        first = ((block_header_t *) list) - 1;
+        for (last = first, count = 1; last->next != NULL; last = last->next) {
+            POOL_PROFILE_RELEASE(last + 1);
+            count++;
+        }
+        POOL_PROFILE_RELEASE(last + 1);
+        POOL_PROBE3(block_release_list, pool, list, count);
+
+        pool_lock_shared(&pool->lock, pool->shared);
+        last->next       = pool->search;
+        pool->search     = first;
+        pool->available += count;
+        if (pool->waiters > 0) {
+            pool->wake++;
+            wake = (count < pool->waiters) ? (uint32_t) count : pool->waiters;
+        }
+        pool_unlock_shared(&pool->lock, pool->shared);
+
+        if (wake > 0) {
+            pool_wake(&pool->wake, wake);
         }
     }
-}
\ No newline at end of file
+
+    return count;
+}
+
+/* take a block, running shrinkers if there is none. untouched is read along with the block */
+static void *block_pool_allocate(block_pool_t *pool, void **untouched) {
+    void   *block = NULL;
+    size_t spare;
+
+    if (block_pool_is_valid(pool)) {
+        POOL_PROBE1(block_allocate_start, pool);
+
+        pool_lock_shared(&pool->lock, pool->shared);
+        *untouched = pool->untouched;
+        block      = block_pool_take(pool);
+        spare      = pool->available * pool->alignment;
+        pool_unlock_shared(&pool->lock, pool->shared);
+
+        /* shrinkers run unlocked so they can release blocks back into this pool */
+        if (block == NULL) {
+            if (pool_shrink(&pool->shrink, pool->alignment) > 0) {
+                pool_lock_shared(&pool->lock, pool->shared);
+                *untouched = pool->untouched;
+                block      = block_pool_take(pool);
+                pool_unlock_shared(&pool->lock, pool->shared);
+            }
+        } else if (spare < pool->shrink.watermark) {
+            pool_shrink(&pool->shrink, pool->shrink.watermark - spare);
+        }
+
+        POOL_PROBE3(block_allocate, pool, block, pool->alignment);
+    }
+    return block;
+}
+
+static void *block_pool_take(block_pool_t *pool) {
+    block_header_t *block = NULL;
+    if (pool->search != NULL && pool->available > 0) {
+        block = pool->search;
+        pool->search = block->next;
+        block->owner = pool;
+        pool->available--;
+        block = block + 1; /* move block ptr to user space */
+        if ((void *) block + pool->alignment > pool->untouched) {
+            pool->untouched = (void *) block + pool->alignment;
+        }
+    }
+    return block;
+}
@@ -0,0 +1,191 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "byte_compact_pool.h"
+#include <stdbool.h>
+
+#define BYTE_COMPACT_FREE 1u
+
+typedef struct byte_compact_header_t {
+    uint32_t next;  /* offset of the next header, BYTE_COMPACT_FREE set while free */
+    uint32_t prev;  /* offset of the previous header */
+} byte_compact_header_t;
+
+static byte_compact_header_t *byte_compact_header(byte_compact_pool_t *pool, uint32_t offset);
+
+static uint32_t byte_compact_end(byte_compact_pool_t *pool);
+
+static uint32_t byte_compact_offset_of(byte_compact_pool_t *pool, void *memory);
+
+static void byte_compact_merge_next(byte_compact_pool_t *pool, uint32_t offset);
+
+void byte_compact_pool_init(byte_compact_pool_t *pool, void *memory, size_t size) {
+    char   *start;
+    size_t skip;
+    size_t end;
+
+    if (pool != NULL && memory != NULL) {
+        start = (char *) (((uintptr_t) memory + BYTE_COMPACT_ALIGNMENT - 1) & ~(uintptr_t) (BYTE_COMPACT_ALIGNMENT - 1));
+        skip  = start - (char *) memory;
+        size  = (size > skip) ? size - skip : 0;
+        size  = (size > UINT32_MAX) ? UINT32_MAX : size;
+        size &= ~(size_t) (BYTE_COMPACT_ALIGNMENT - 1);
+
+        if (size >= 2 * sizeof(byte_compact_header_t) + BYTE_COMPACT_MIN) {
+            end             = size - sizeof(byte_compact_header_t);
+            pool->start     = start;
+            pool->end       = start + end;
+            pool->search    = 0;
+            pool->capacity  = end - sizeof(byte_compact_header_t);
+            pool->fragments = 1;
+
+            /* one free block, then a terminating header that looks allocated */
+            byte_compact_header(pool, 0)->next   = (uint32_t) end | BYTE_COMPACT_FREE;
+            byte_compact_header(pool, 0)->prev   = 0;
+            byte_compact_header(pool, end)->next = (uint32_t) end;
+            byte_compact_header(pool, end)->prev = 0;
+        }
+    }
+}
+
+int byte_compact_pool_is_valid(byte_compact_pool_t *pool) {
+    return (pool != NULL)
+           && (pool->start != NULL)
+           && (pool->start < pool->end)
+           && (pool->search < byte_compact_end(pool))
+           && (pool->capacity < byte_compact_end(pool));
+}
+
+void *byte_compact_allocate(byte_compact_pool_t *pool, size_t size) {
+    void                  *return_ptr = NULL;
+    byte_compact_header_t *block;
+    byte_compact_header_t *split;
+    uint32_t              offset;
+    uint32_t              next;
+
+    if (byte_compact_pool_is_valid(pool) && size > 0 && size <= pool->capacity) {
+        size   = (size + BYTE_COMPACT_ALIGNMENT - 1) & ~(size_t) (BYTE_COMPACT_ALIGNMENT - 1);
+        offset = pool->search;
+
+        /* next fit, wrapping around at the terminating header */
+        do {
+            block = byte_compact_header(pool, offset);
+            next  = block->next & ~BYTE_COMPACT_FREE;
+
+            if (offset == byte_compact_end(pool)) {
+                offset = 0;
+            } else if ((block->next & BYTE_COMPACT_FREE) && next - offset - sizeof(*block) >= size) {
+                if (next - offset - sizeof(*block) - size >= sizeof(*block) + BYTE_COMPACT_MIN) {
+                    split       = byte_compact_header(pool, offset + sizeof(*block) + size);
+                    split->next = next | BYTE_COMPACT_FREE;
+                    split->prev = offset;
+                    next        = offset + sizeof(*block) + size;
+                    byte_compact_header(pool, split->next & ~BYTE_COMPACT_FREE)->prev = next;
+                    pool->capacity -= sizeof(*block);
+                } else {
+                    pool->fragments--;
+                }
+
+                block->next     = next;
+                pool->capacity -= next - offset - sizeof(*block);
+                pool->search    = (next == byte_compact_end(pool)) ? 0 : next;
+                return_ptr      = block + 1;
+                break;
+            } else {
+                offset = next;
+            }
+        } while (offset != pool->search);
+    }
+
+    return return_ptr;
+}
+
+void byte_compact_release(byte_compact_pool_t *pool, void *memory) {
+    uint32_t              offset = byte_compact_offset_of(pool, memory);
+    byte_compact_header_t *block;
+    uint32_t              next;
+
+    if (offset != UINT32_MAX) {
+        block            = byte_compact_header(pool, offset);
+        next             = block->next;
+        block->next     |= BYTE_COMPACT_FREE;
+        pool->capacity  += next - offset - sizeof(*block);
+        pool->fragments++;
+
+        if (byte_compact_header(pool, next)->next & BYTE_COMPACT_FREE) {
+            byte_compact_merge_next(pool, offset);
+        }
+        if (offset > 0 && (byte_compact_header(pool, block->prev)->next & BYTE_COMPACT_FREE)) {
+            byte_compact_merge_next(pool, block->prev);
+        }
+    }
+}
+
+size_t byte_compact_size(byte_compact_pool_t *pool, void *memory) {
+    uint32_t offset = byte_compact_offset_of(pool, memory);
+    size_t   size   = 0;
+
+    if (offset != UINT32_MAX) {
+        size = byte_compact_header(pool, offset)->next - offset - sizeof(byte_compact_header_t);
+    }
+
+    return size;
+}
+
+static byte_compact_header_t *byte_compact_header(byte_compact_pool_t *pool, uint32_t offset) {
+    return (byte_compact_header_t *) ((char *) pool->start + offset);
+}
+
+static uint32_t byte_compact_end(byte_compact_pool_t *pool) {
+    return (uint32_t) ((char *) pool->end - (char *) pool->start);
+}
+
+/* header offset of allocated memory, UINT32_MAX if memory isn't allocated from pool */
+static uint32_t byte_compact_offset_of(byte_compact_pool_t *pool, void *memory) {
+    byte_compact_header_t *block;
+    uint32_t              offset;
+    uint32_t              next;
+    uint32_t              prev;
+
+    if (!byte_compact_pool_is_valid(pool) || (char *) memory < (char *) pool->start + sizeof(*block)
+        || memory > pool->end || ((uintptr_t) memory & (BYTE_COMPACT_ALIGNMENT - 1)) != 0) {
+        return UINT32_MAX;
+    }
+
+    offset = (uint32_t) ((char *) memory - (char *) pool->start) - sizeof(*block);
+    block  = byte_compact_header(pool, offset);
+    next   = block->next;
+    prev   = block->prev;
+    if ((next & (BYTE_COMPACT_ALIGNMENT - 1)) != 0 || next <= offset || next > byte_compact_end(pool)
+        || offset == byte_compact_end(pool)) {
+        return UINT32_MAX;
+    }
+
+    /* interior pointers can look like a header, a real block is linked from both neighbours */
+    if (byte_compact_header(pool, next)->prev != offset) {
+        return UINT32_MAX;
+    }
+    if (offset > 0 && ((prev & (BYTE_COMPACT_ALIGNMENT - 1)) != 0 || prev >= offset
+                       || (byte_compact_header(pool, prev)->next & ~BYTE_COMPACT_FREE) != offset)) {
+        return UINT32_MAX;
+    }
+
+    return offset;
+}
+
+/* absorb the free block after offset into it */
+static void byte_compact_merge_next(byte_compact_pool_t *pool, uint32_t offset) {
+    byte_compact_header_t *block = byte_compact_header(pool, offset);
+    uint32_t              next   = block->next & ~BYTE_COMPACT_FREE;
+    uint32_t              after  = byte_compact_header(pool, next)->next & ~BYTE_COMPACT_FREE;
+
+    block->next = after | BYTE_COMPACT_FREE;
+    byte_compact_header(pool, after)->prev = offset;
+    pool->capacity += sizeof(*block);
+    pool->fragments--;
+
+    if (pool->search == next) {
+        pool->search = offset;
+    }
+}
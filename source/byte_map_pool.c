@@ -0,0 +1,265 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "byte_map_pool.h"
+#include <stdbool.h>
+
+#define BYTE_MAP_NONE ((size_t) -1)
+
+static bool byte_map_bit(const uint64_t *map, size_t bit);
+
+static void byte_map_fill(uint64_t *map, size_t first, size_t count, bool value);
+
+static size_t byte_map_find_run(byte_map_pool_t *pool, size_t from, size_t to, size_t count);
+
+static size_t byte_map_find_last(byte_map_pool_t *pool, size_t granule);
+
+static size_t byte_map_granule_of(byte_map_pool_t *pool, void *memory);
+
+void byte_map_pool_init(byte_map_pool_t *pool, void *metadata, size_t metadata_size, void *memory, size_t size) {
+    char   *start;
+    size_t granules;
+    size_t words;
+
+    if (pool != NULL && metadata != NULL && memory != NULL) {
+        start    = (char *) (((uintptr_t) memory + BYTE_MAP_GRANULE - 1) & ~(uintptr_t) (BYTE_MAP_GRANULE - 1));
+        granules = (size > (size_t) (start - (char *) memory)) ? (size - (start - (char *) memory)) / BYTE_MAP_GRANULE : 0;
+        words    = (granules + 63) / 64;
+
+        if (granules > 0 && metadata_size >= 2 * words * sizeof(uint64_t)) {
+            pool->start     = start;
+            pool->end       = start + granules * BYTE_MAP_GRANULE;
+            pool->used      = metadata;
+            pool->last      = pool->used + words;
+            pool->granules  = granules;
+            pool->search    = 0;
+            pool->capacity  = granules * BYTE_MAP_GRANULE;
+            pool->fragments = 1;
+
+            byte_map_fill(pool->used, 0, words * 64, false);
+            byte_map_fill(pool->last, 0, words * 64, false);
+
+            /* granules past the end of memory look allocated so scans stop there */
+            byte_map_fill(pool->used, granules, words * 64 - granules, true);
+        }
+    }
+}
+
+int byte_map_pool_is_valid(byte_map_pool_t *pool) {
+    return (pool != NULL)
+           && (pool->start != NULL)
+           && (pool->used != NULL)
+           && (pool->last != NULL)
+           && (pool->granules > 0)
+           && (pool->start < pool->end)
+           && (pool->search < pool->granules)
+           && (pool->capacity <= pool->granules * BYTE_MAP_GRANULE);
+}
+
+void *byte_map_allocate(byte_map_pool_t *pool, size_t size) {
+    void   *return_ptr = NULL;
+    size_t count;
+    size_t first;
+
+    if (byte_map_pool_is_valid(pool) && size > 0 && size <= pool->capacity) {
+        count = (size + BYTE_MAP_GRANULE - 1) / BYTE_MAP_GRANULE;
+
+        /* next fit, wrapping around to the start of the pool */
+        first = byte_map_find_run(pool, pool->search, pool->granules, count);
+        if (first == BYTE_MAP_NONE && pool->search > 0) {
+            first = byte_map_find_run(pool, 0, pool->search + count - 1 < pool->granules
+                                               ? pool->search + count - 1 : pool->granules, count);
+        }
+
+        if (first != BYTE_MAP_NONE) {
+            bool free_before = first > 0 && !byte_map_bit(pool->used, first - 1);
+            bool free_after  = first + count < pool->granules && !byte_map_bit(pool->used, first + count);
+
+            /* taking a whole run removes a fragment, taking the middle of one splits it */
+            if (!free_before && !free_after) {
+                pool->fragments--;
+            } else if (free_before && free_after) {
+                pool->fragments++;
+            }
+
+            byte_map_fill(pool->used, first, count, true);
+            byte_map_fill(pool->last, first + count - 1, 1, true);
+            pool->capacity -= count * BYTE_MAP_GRANULE;
+            pool->search    = (first + count < pool->granules) ? first + count : 0;
+            return_ptr      = (char *) pool->start + first * BYTE_MAP_GRANULE;
+        }
+    }
+
+    return return_ptr;
+}
+
+void byte_map_release(byte_map_pool_t *pool, void *memory) {
+    size_t first = byte_map_granule_of(pool, memory);
+    size_t last;
+    bool   free_before;
+    bool   free_after;
+
+    if (first != BYTE_MAP_NONE) {
+        last        = byte_map_find_last(pool, first);
+        free_before = first > 0 && !byte_map_bit(pool->used, first - 1);
+        free_after  = last + 1 < pool->granules && !byte_map_bit(pool->used, last + 1);
+
+        /* joining two free neighbours removes a fragment, an isolated release adds one */
+        if (free_before && free_after) {
+            pool->fragments--;
+        } else if (!free_before && !free_after) {
+            pool->fragments++;
+        }
+
+        byte_map_fill(pool->used, first, last - first + 1, false);
+        byte_map_fill(pool->last, last, 1, false);
+        pool->capacity += (last - first + 1) * BYTE_MAP_GRANULE;
+    }
+}
+
+size_t byte_map_size(byte_map_pool_t *pool, void *memory) {
+    size_t first = byte_map_granule_of(pool, memory);
+    size_t size  = 0;
+
+    if (first != BYTE_MAP_NONE) {
+        size = (byte_map_find_last(pool, first) - first + 1) * BYTE_MAP_GRANULE;
+    }
+
+    return size;
+}
+
+size_t byte_map_pool_purge(byte_map_pool_t *pool, pool_purge_t *purge) {
+    size_t   granule = 0;
+    size_t   first;
+    size_t   purged  = 0;
+    uint64_t word;
+
+    if (byte_map_pool_is_valid(pool) && pool_purge_ready(purge) && pool_purge_worth(purge, pool->capacity)) {
+        while (granule < pool->granules) {
+            if (byte_map_bit(pool->used, granule)) {
+                /* skip allocated granules to the start of a free run */
+                word     = ~(pool->used[granule / 64] >> (granule % 64));
+                granule += (word == 0) ? 64 - granule % 64 : (size_t) __builtin_ctzll(word);
+                continue;
+            }
+
+            /* then free granules to its end, padding past granules reads as allocated */
+            first = granule;
+            do {
+                word     = pool->used[granule / 64] >> (granule % 64);
+                granule += (word == 0) ? 64 - granule % 64 : (size_t) __builtin_ctzll(word);
+            } while (granule < pool->granules && !byte_map_bit(pool->used, granule));
+
+            if (granule > pool->granules) {
+                granule = pool->granules;
+            }
+            purged += pool_purge_range(purge, (char *) pool->start + first * BYTE_MAP_GRANULE,
+                                       (char *) pool->start + granule * BYTE_MAP_GRANULE);
+        }
+
+        purge->purged += purged;
+        pool_purge_done(purge, pool->capacity);
+    }
+
+    return purged;
+}
+
+static bool byte_map_bit(const uint64_t *map, size_t bit) {
+    return (map[bit / 64] >> (bit % 64)) & 1u;
+}
+
+static void byte_map_fill(uint64_t *map, size_t first, size_t count, bool value) {
+    size_t   bit;
+    size_t   span;
+    uint64_t mask;
+
+    while (count > 0) {
+        bit  = first % 64;
+        span = (64 - bit < count) ? 64 - bit : count;
+        mask = (span == 64) ? ~(uint64_t) 0 : (((uint64_t) 1 << span) - 1) << bit;
+
+        if (value) {
+            map[first / 64] |= mask;
+        } else {
+            map[first / 64] &= ~mask;
+        }
+
+        first += span;
+        count -= span;
+    }
+}
+
+/* first granule of a free run of count granules in [from, to), scanning a word at a time */
+static size_t byte_map_find_run(byte_map_pool_t *pool, size_t from, size_t to, size_t count) {
+    size_t   granule = from;
+    size_t   run     = 0;
+    size_t   first   = from;
+    size_t   span;
+    size_t   bits;
+    uint64_t word;
+
+    while (granule < to) {
+        word = pool->used[granule / 64] >> (granule % 64);
+        span = 64 - granule % 64;
+        if (granule + span > to) {
+            span = to - granule;
+        }
+
+        /* free granules before the next allocated one */
+        bits = (word == 0) ? span : (size_t) __builtin_ctzll(word);
+        bits = (bits < span) ? bits : span;
+        if (bits > 0) {
+            if (run == 0) {
+                first = granule;
+            }
+            run     += bits;
+            granule += bits;
+            if (run >= count) {
+                return first;
+            }
+        }
+
+        if (bits < span) {
+            /* skip allocated granules */
+            run = 0;
+            word = ~(pool->used[granule / 64] >> (granule % 64));
+            granule += (word == 0) ? 64 - granule % 64 : (size_t) __builtin_ctzll(word);
+        }
+    }
+
+    return BYTE_MAP_NONE;
+}
+
+/* last granule of the allocation starting at granule */
+static size_t byte_map_find_last(byte_map_pool_t *pool, size_t granule) {
+    uint64_t word = pool->last[granule / 64] >> (granule % 64);
+
+    if (word != 0) {
+        return granule + __builtin_ctzll(word);
+    }
+
+    granule = (granule / 64 + 1) * 64;
+    while (pool->last[granule / 64] == 0) {
+        granule += 64;
+    }
+    return granule + __builtin_ctzll(pool->last[granule / 64]);
+}
+
+/* granule index of the start of an allocation, BYTE_MAP_NONE if memory isn't one */
+static size_t byte_map_granule_of(byte_map_pool_t *pool, void *memory) {
+    size_t granule;
+
+    if (!byte_map_pool_is_valid(pool) || memory < pool->start || memory >= pool->end
+        || ((char *) memory - (char *) pool->start) % BYTE_MAP_GRANULE != 0) {
+        return BYTE_MAP_NONE;
+    }
+
+    granule = ((char *) memory - (char *) pool->start) / BYTE_MAP_GRANULE;
+    if (!byte_map_bit(pool->used, granule) || (granule > 0 && byte_map_bit(pool->used, granule - 1)
+                                                  && !byte_map_bit(pool->last, granule - 1))) {
+        return BYTE_MAP_NONE;
+    }
+
+    return granule;
+}
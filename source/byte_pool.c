@@ -3,7 +3,17 @@
 //
 
 #include "byte_pool.h"
+#include "pool_probe.h"
+#include "pool_profile.h"
+#include "pool_trace.h"
+#include "pool_zero.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* owner tag of handle memory, the header then points at the handle entry instead of the pool */
+#define BYTE_HANDLE_TAG ((uintptr_t) 1)
 
 typedef struct byte_header_t byte_header_t;
 
@@ -38,6 +48,22 @@ void byte_block_free(byte_pool_t *pool, byte_header_t *block);
 
 byte_header_t *byte_block_get_next(byte_header_t *);
 
+static void *byte_pool_allocate(byte_pool_t *pool, size_t size, void **untouched);
+
+static void *byte_pool_find(byte_pool_t *pool, size_t size, size_t *walk);
+
+static void *byte_pool_search(byte_pool_t *pool, byte_header_t *block, void *stop, size_t size, size_t *walk);
+
+static byte_handle_entry_t *byte_handle_of(byte_handle_table_t *table, byte_header_t *block);
+
+static byte_pool_t *byte_block_owner(byte_header_t *block);
+
+static void byte_pool_link(byte_pool_t *pool, byte_header_t *last, byte_header_t *block);
+
+static int byte_pool_compare(const void *a, const void *b);
+
+static size_t byte_pool_sweep(byte_pool_t *pool, void **ptrs, size_t count);
+
 void byte_pool_init(byte_pool_t *pool, void *memory, size_t size) {
     byte_header_t *header;
 
@@ -47,6 +73,9 @@ void byte_pool_init(byte_pool_t *pool, void *memory, size_t size) {
         pool->end       = memory + size - sizeof(byte_header_t);
         pool->fragments = 1;
         pool->capacity  = size - sizeof(byte_header_t) - sizeof(byte_header_t);
+        pool->untouched = (byte_header_t *) memory + 1;
+        pool->zeroed    = 0;
+        pool_shrink_init(&pool->shrink);
 
         header = pool->start;
         header->owner       = NULL;
@@ -78,42 +107,53 @@ void byte_pool_defragment(byte_pool_t *pool) {
 }
 
 void *byte_allocate(byte_pool_t *pool, size_t size) {
-    void          *return_ptr = NULL;
-    byte_header_t *block;
-    byte_header_t *next;
+    void *untouched;
+    void *return_ptr = NULL;
 
     if (byte_pool_is_valid(pool) && size > 0) {
-        block = pool->search;
+        return_ptr = byte_pool_allocate(pool, size, &untouched);
 
-        while (byte_block_is_valid(block) && return_ptr == NULL) {
-            if (byte_block_is_free(block)) {
-                if (byte_block_get_size(&block) < size) {
-                    next = byte_block_get_next(block);
+        POOL_TRACE(POOL_TRACE_ALLOCATE, pool, return_ptr, size);
+        POOL_PROFILE_ALLOCATE(pool, return_ptr, size);
+    }
 
-                    if (byte_block_is_valid(next) && byte_block_is_free(next)) {
-                        byte_block_merge_next(pool, block);
-                    } else {
-                        block = byte_block_get_next(next);
-                    }
-                } else {
-                    return_ptr = byte_block_allocate(pool, &block, size);
-                }
-            } else {
-                block = byte_block_get_next(block);
-            }
+    return return_ptr;
+}
+
+void *byte_allocate_zeroed(byte_pool_t *pool, size_t size) {
+    void *untouched;
+    void *return_ptr = NULL;
+
+    if (byte_pool_is_valid(pool) && size > 0 && size <= SIZE_MAX - (sizeof(void *) - 1)) {
+        /* whole words so the header split off behind the block stays aligned for the wide clears */
+        size       = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+        return_ptr = byte_pool_allocate(pool, size, &untouched);
+        if (return_ptr != NULL) {
+            pool_zero_used(return_ptr, size, untouched, pool->zeroed);
         }
+
+        POOL_TRACE(POOL_TRACE_ALLOCATE, pool, return_ptr, size);
+        POOL_PROFILE_ALLOCATE(pool, return_ptr, size);
     }
 
     return return_ptr;
 }
 
+void byte_pool_mark_zeroed(byte_pool_t *pool) {
+    if (byte_pool_is_valid(pool)) {
+        pool->zeroed = 1;
+    }
+}
 
 void byte_release(void *memory) {
     byte_header_t *block = get_header_from_memory(memory);
 
     if (!byte_block_is_free(block)) {
-        byte_pool_t *pool = block->owner;
+        byte_pool_t *pool = byte_block_owner(block);
         if (byte_pool_is_valid(pool)) {
+            POOL_TRACE(POOL_TRACE_RELEASE, pool, memory, byte_block_get_size(&block));
+            POOL_PROBE3(byte_release, pool, memory, block->next);
+            POOL_PROFILE_RELEASE(memory);
             byte_block_free(pool, block);
         }
     }
@@ -123,8 +163,9 @@ size_t byte_size(void *memory) {
     if(memory != NULL) {
         byte_header_t *block = get_header_from_memory(memory);
         if (!byte_block_is_free(block)) {
-            byte_pool_t *pool = block->owner;
+            byte_pool_t *pool = byte_block_owner(block);
             if (byte_pool_is_valid(pool)) {
+                POOL_TRACE(POOL_TRACE_SIZE, pool, memory, byte_block_get_size(&block));
                 return byte_block_get_size(&block);
             }
         }
@@ -132,6 +173,202 @@ size_t byte_size(void *memory) {
     return 0;
 }
 
+size_t byte_release_batch(void **ptrs, size_t count) {
+    byte_header_t *block;
+    byte_pool_t   *pool;
+    size_t        released = 0;
+    size_t        first    = 0;
+    size_t        last;
+
+    if (ptrs == NULL || count == 0) {
+        return 0;
+    }
+
+    qsort(ptrs, count, sizeof(void *), byte_pool_compare);
+
+    while (first < count) {
+        if (ptrs[first] == NULL || byte_block_is_free(block = get_header_from_memory(ptrs[first]))
+            || !byte_pool_is_valid(pool = byte_block_owner(block))) {
+            first++;
+            continue;
+        }
+
+        /* pools don't overlap, so the rest of this pool's pointers follow */
+        for (last = first + 1; last < count && ptrs[last] < pool->end; last++);
+
+        released += byte_pool_sweep(pool, &ptrs[first], last - first);
+        first     = last;
+    }
+
+    return released;
+}
+
+size_t byte_pool_purge(byte_pool_t *pool, pool_purge_t *purge) {
+    byte_header_t *block;
+    size_t        purged = 0;
+
+    if (byte_pool_is_valid(pool) && pool_purge_ready(purge) && pool_purge_worth(purge, pool->capacity)) {
+        byte_pool_defragment(pool);
+
+        for (block = pool->start; byte_block_is_valid(block); block = block->next) {
+            if (byte_block_is_free(block)) {
+                /* payload only, this header and the next stay resident */
+                purged += pool_purge_range(purge, block + 1, block->next);
+            }
+        }
+
+        purge->purged += purged;
+        pool_purge_done(purge, pool->capacity);
+    }
+
+    return purged;
+}
+
+void byte_handle_table_init(byte_handle_table_t *table, byte_pool_t *pool, byte_handle_entry_t *entries, size_t count) {
+    if (table != NULL && byte_pool_is_valid(pool) && entries != NULL && count > 0) {
+        table->pool    = pool;
+        table->entries = entries;
+        table->count   = count;
+        table->free    = NULL;
+
+        /* chain entries so the lowest is handed out first */
+        for (size_t i = count; i > 0; i--) {
+            entries[i - 1].memory = NULL;
+            entries[i - 1].next   = table->free;
+            entries[i - 1].locks  = 0;
+            table->free           = &entries[i - 1];
+        }
+    }
+}
+
+byte_handle_t byte_handle_allocate(byte_handle_table_t *table, size_t size) {
+    byte_handle_entry_t *handle = NULL;
+    void                *memory;
+
+    if (table != NULL && table->free != NULL) {
+        memory = byte_allocate(table->pool, size);
+        if (memory == NULL && byte_pool_compact(table) > 0) {
+            memory = byte_allocate(table->pool, size);
+        }
+
+        if (memory != NULL) {
+            handle         = table->free;
+            table->free    = handle->next;
+            handle->memory = memory;
+            handle->next   = NULL;
+            handle->locks  = 0;
+
+            /* the header points at the handle so compaction can find it, tagged so
+             * byte_release and byte_size pass over memory only the table may release */
+            get_header_from_memory(memory)->owner = (byte_pool_t *) ((uintptr_t) handle | BYTE_HANDLE_TAG);
+        }
+    }
+
+    return handle;
+}
+
+void byte_handle_release(byte_handle_table_t *table, byte_handle_t handle) {
+    byte_header_t *block;
+
+    if (table != NULL && handle != NULL && handle->memory != NULL && handle->locks == 0) {
+        block = get_header_from_memory(handle->memory);
+        if (byte_handle_of(table, block) == handle) {
+            POOL_TRACE(POOL_TRACE_RELEASE, table->pool, handle->memory, byte_block_get_size(&block));
+            POOL_PROFILE_RELEASE(handle->memory);
+            byte_block_free(table->pool, block);
+
+            handle->memory = NULL;
+            handle->next   = table->free;
+            table->free    = handle;
+        }
+    }
+}
+
+void *byte_handle_lock(byte_handle_t handle) {
+    void *memory = NULL;
+
+    if (handle != NULL && handle->memory != NULL) {
+        handle->locks++;
+        memory = handle->memory;
+    }
+
+    return memory;
+}
+
+void byte_handle_unlock(byte_handle_t handle) {
+    if (handle != NULL && handle->locks > 0) {
+        handle->locks--;
+    }
+}
+
+size_t byte_pool_compact(byte_handle_table_t *table) {
+    byte_pool_t         *pool;
+    byte_header_t       *block, *next, *last = NULL, *destination;
+    byte_handle_entry_t *handle;
+    size_t              size;
+    size_t              moved = 0;
+
+    if (table == NULL || !byte_pool_is_valid(table->pool)) {
+        return 0;
+    }
+
+    pool            = table->pool;
+    destination     = pool->start;
+    pool->capacity  = 0;
+    pool->fragments = 0;
+
+    for (block = pool->start; byte_block_is_valid(block); block = next) {
+        next = block->next;
+        size = byte_block_get_size(&block);
+
+        if (byte_block_is_free(block)) {
+            continue;
+        }
+
+        handle = byte_handle_of(table, block);
+        if (handle == NULL || handle->locks > 0) {
+            /* pinned, free space gathered in front of it becomes one free block */
+            if (destination != block) {
+                destination->owner = NULL;
+                byte_pool_link(pool, last, destination);
+                last = destination;
+            }
+            byte_pool_link(pool, last, block);
+            last        = block;
+            destination = next;
+        } else {
+            if (destination != block) {
+                memmove(destination, block, sizeof(byte_header_t) + size);
+                POOL_PROFILE_MOVE(block + 1, destination + 1);
+                handle->memory = destination + 1;
+                moved++;
+            }
+            byte_pool_link(pool, last, destination);
+            last        = destination;
+            destination = (void *) (destination + 1) + size;
+        }
+    }
+
+    /* whatever is left before the terminating header is one free block */
+    if (destination != block) {
+        destination->owner = NULL;
+        byte_pool_link(pool, last, destination);
+        last = destination;
+    }
+    byte_pool_link(pool, last, block);
+
+    for (block = pool->start, pool->search = NULL; byte_block_is_valid(block); block = block->next) {
+        if (byte_block_is_free(block) && pool->search == NULL) {
+            pool->search = block;
+        }
+    }
+    if (pool->search == NULL) {
+        pool->search = pool->start;
+    }
+
+    return moved;
+}
+
 int byte_pool_is_valid(byte_pool_t *pool) {
     return (pool != NULL)
            && (pool->start != NULL)
@@ -166,6 +403,7 @@ size_t byte_block_get_size(byte_header_t **block) {
 void byte_block_merge_next(byte_pool_t *pool, byte_header_t *block) {
     if (pool != NULL && block != NULL) {
         byte_header_t *next = block->next;
+        POOL_PROBE3(byte_block_merge_next, pool, block, next);
         block->next = next->next;
         pool->fragments--;
         pool->capacity += sizeof(byte_header_t);
@@ -193,7 +431,9 @@ void byte_block_split(byte_pool_t *pool, byte_header_t **block, size_t size) {
             tail  = head->next;
             split = (void *) (head + 1) + size;
             head->next  = split;
-            split->next = tail;
+            split->next  = tail;
+            split->owner = NULL; /* memory may hold a stale header of an earlier block */
+            POOL_PROBE4(byte_block_split, pool, head, size, (void *) tail - (void *) (split + 1));
             pool->fragments++;
             pool->capacity -= sizeof(byte_header_t);
         }
@@ -212,9 +452,12 @@ void *byte_block_allocate(byte_pool_t *pool, byte_header_t **block, size_t size)
             (*block)->owner = pool;
             return_ptr = *block + 1;
             pool->capacity -= byte_block_get_size(block);
-            if ((*block) == pool->search) {
-                pool->search = (*block)->next;
+            /* the following header may become part of a block once merged */
+            if ((void *) ((*block)->next + 1) > pool->untouched) {
+                pool->untouched = (*block)->next + 1;
             }
+            /* next fit, resume the following search after this block */
+            pool->search = (*block)->next;
         }
     }
 
@@ -240,3 +483,148 @@ byte_header_t *byte_block_get_next(byte_header_t *block) {
 
     return next;
 }
+
+/* handle owning block, Null if block isn't handle memory from table */
+static byte_handle_entry_t *byte_handle_of(byte_handle_table_t *table, byte_header_t *block) {
+    byte_handle_entry_t *handle = (byte_handle_entry_t *) ((uintptr_t) block->owner & ~BYTE_HANDLE_TAG);
+
+    if (((uintptr_t) block->owner & BYTE_HANDLE_TAG) == 0 || handle < table->entries || handle >= table->entries + table->count) {
+        return NULL;
+    }
+    return handle;
+}
+
+/* pool owning allocated block, Null for handle memory */
+static byte_pool_t *byte_block_owner(byte_header_t *block) {
+    return ((uintptr_t) block->owner & BYTE_HANDLE_TAG) ? NULL : block->owner;
+}
+
+/* make block follow last, counting what it adds to the pool */
+static void byte_pool_link(byte_pool_t *pool, byte_header_t *last, byte_header_t *block) {
+    if (last != NULL) {
+        last->next = block;
+        pool->fragments++;
+        if (byte_block_is_free(last)) {
+            pool->capacity += byte_block_get_size(&last);
+        }
+    }
+}
+
+/* find a block, running shrinkers if there is none. untouched is read just before the block is taken */
+static void *byte_pool_allocate(byte_pool_t *pool, size_t size, void **untouched) {
+    void   *return_ptr;
+    size_t walk = 0;
+
+    POOL_PROBE2(byte_allocate_start, pool, size);
+
+    *untouched = pool->untouched;
+    return_ptr = byte_pool_find(pool, size, &walk);
+
+    /* under pressure ask the shrinkers for memory, retrying once if they gave some back */
+    if (return_ptr == NULL) {
+        if (pool_shrink(&pool->shrink, size + sizeof(byte_header_t)) > 0) {
+            *untouched = pool->untouched;
+            return_ptr = byte_pool_find(pool, size, &walk);
+        }
+    } else if (pool->capacity < pool->shrink.watermark) {
+        pool_shrink(&pool->shrink, pool->shrink.watermark - pool->capacity);
+    }
+
+    POOL_PROBE4(byte_allocate, pool, return_ptr, size, walk);
+
+    return return_ptr;
+}
+
+/* next fit from the search pointer, wrapping around to blocks released behind it */
+static void *byte_pool_find(byte_pool_t *pool, size_t size, size_t *walk) {
+    void *origin     = pool->search;
+    void *return_ptr = byte_pool_search(pool, pool->search, NULL, size, walk);
+
+    if (return_ptr == NULL && origin != pool->start) {
+        return_ptr = byte_pool_search(pool, pool->start, origin, size, walk);
+    }
+
+    return return_ptr;
+}
+
+/* first fit walk from block, merging free neighbours on the way, until stop or end of pool. walk counts steps */
+static void *byte_pool_search(byte_pool_t *pool, byte_header_t *block, void *stop, size_t size, size_t *walk) {
+    void          *return_ptr = NULL;
+    byte_header_t *next;
+
+    while (byte_block_is_valid(block) && (stop == NULL || (void *) block < stop) && return_ptr == NULL) {
+        (*walk)++;
+        if (byte_block_is_free(block)) {
+            if (byte_block_get_size(&block) < size) {
+                next = byte_block_get_next(block);
+
+                if (byte_block_is_valid(next) && byte_block_is_free(next)) {
+                    byte_block_merge_next(pool, block);
+                } else {
+                    block = byte_block_get_next(next);
+                }
+            } else {
+                return_ptr = byte_block_allocate(pool, &block, size);
+            }
+        } else {
+            block = byte_block_get_next(block);
+        }
+    }
+
+    return return_ptr;
+}
+
+static int byte_pool_compare(const void *a, const void *b) {
+    uintptr_t left  = (uintptr_t) *(void *const *) a;
+    uintptr_t right = (uintptr_t) *(void *const *) b;
+
+    return (left > right) - (left < right);
+}
+
+/* free sorted blocks of pool and merge free runs, walking until the last freed block's run ends */
+static size_t byte_pool_sweep(byte_pool_t *pool, void **ptrs, size_t count) {
+    byte_header_t *block    = pool->start;
+    byte_header_t *run      = NULL;
+    byte_header_t *next;
+    size_t        index    = 0;
+    size_t        freed    = 0;
+    size_t        merged   = 0;
+    size_t        released = 0;
+
+    while (byte_block_is_valid(block) && (index < count || run != NULL)) {
+        next = block->next;
+
+        /* pointers into the middle of blocks or repeated ones are passed over */
+        while (index < count && get_header_from_memory(ptrs[index]) < block) {
+            index++;
+        }
+        if (index < count && get_header_from_memory(ptrs[index]) == block) {
+            index++;
+            if (block->owner == pool) {
+                POOL_TRACE(POOL_TRACE_RELEASE, pool, block + 1, byte_block_get_size(&block));
+                POOL_PROFILE_RELEASE(block + 1);
+                block->owner = NULL;
+                freed       += byte_block_get_size(&block);
+                released++;
+            }
+        }
+
+        if (!byte_block_is_free(block)) {
+            run = NULL;
+        } else if (run == NULL) {
+            run = block;
+        } else {
+            run->next = next;
+            merged++;
+            if (pool->search == block) {
+                pool->search = run;
+            }
+        }
+
+        block = next;
+    }
+
+    pool->capacity  += freed + merged * sizeof(byte_header_t);
+    pool->fragments -= merged;
+    return released;
+}
@@ -0,0 +1,629 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* MAP_ANONYMOUS, MAP_NORESERVE */
+#endif
+
+#include "cpool_malloc.h"
+#include "block_pool.h"
+#include "byte_pool.h"
+#include "pool_sync.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef CPOOL_MALLOC_CHUNK
+#define CPOOL_MALLOC_CHUNK (64u << 10) /* memory behind each size class block pool */
+#endif
+
+#ifndef CPOOL_MALLOC_ARENA
+#define CPOOL_MALLOC_ARENA (4u << 20) /* memory behind each byte pool */
+#endif
+
+#ifndef CPOOL_MALLOC_RESERVE
+#define CPOOL_MALLOC_RESERVE ((size_t) 16 << 30) /* address space reserved for block chunks and for byte arenas each */
+#endif
+
+#ifndef CPOOL_MALLOC_CACHE
+#define CPOOL_MALLOC_CACHE 64 /* blocks per size class cached by each thread */
+#endif
+
+#define CPOOL_MALLOC_ALIGN   16
+#define CPOOL_MALLOC_MAGIC   ((uintptr_t) 0x63706f6f6c687567u) /* mixed into huge headers */
+#define CPOOL_MALLOC_CLASSES (sizeof(cpool_class_sizes) / sizeof(cpool_class_sizes[0]))
+#define CPOOL_MALLOC_SMALL   1032
+
+/* sizes are 8 mod 16 so the block stride, size plus 8 byte header, keeps payloads 16 byte aligned */
+static const size_t cpool_class_sizes[] = {
+    24, 40, 56, 72, 88, 104, 120, 136, 168, 200, 232, 264, 328, 392, 456, 520, 648, 776, 904, CPOOL_MALLOC_SMALL,
+};
+
+typedef struct cpool_chunk_t cpool_chunk_t;
+
+struct cpool_chunk_t {
+    block_pool_t  pool;
+    cpool_chunk_t *next;    /* next chunk in the class partial list */
+    size_t        class;
+    int           partial;
+};
+
+typedef struct cpool_class_t {
+    volatile int  lock;
+    cpool_chunk_t *current;
+    cpool_chunk_t *partial;
+} cpool_class_t;
+
+typedef struct cpool_huge_t {
+    void      *base;
+    size_t    length;
+    uintptr_t magic;    /* base ^ CPOOL_MALLOC_MAGIC, tells mappings from foreign pointers */
+} cpool_huge_t;
+
+typedef struct cpool_cache_t {
+    void     *head[CPOOL_MALLOC_CLASSES];
+    unsigned count[CPOOL_MALLOC_CLASSES];
+    int      state;
+} cpool_cache_t;
+
+enum {
+    CPOOL_CACHE_UNUSED = 0,
+    CPOOL_CACHE_ACTIVE,
+    CPOOL_CACHE_FINISHED,
+};
+
+static struct {
+    volatile int  lock;
+    volatile int  ready;
+    volatile int  registered;   /* thread cache key and fork handlers are set up */
+    char          *block_start;
+    char          *block_cursor;
+    char          *block_end;
+    char          *byte_start;
+    char          *byte_cursor;
+    char          *byte_end;
+    volatile int  byte_lock;
+    size_t        byte_search;
+    unsigned char class_index[CPOOL_MALLOC_SMALL / CPOOL_MALLOC_ALIGN + 2];
+    cpool_class_t classes[CPOOL_MALLOC_CLASSES];
+    pthread_key_t key;
+} cpool_heap;
+
+static __thread cpool_cache_t cpool_cache __attribute__((tls_model("initial-exec")));
+
+static void cpool_malloc_init(void);
+
+static void cpool_cache_finish(void *cache);
+
+static void *cpool_small_allocate(size_t class);
+
+static void cpool_small_release(cpool_chunk_t *chunk, void *memory);
+
+static void *cpool_mid_allocate(size_t size);
+
+static void *cpool_huge_allocate(size_t size, size_t alignment);
+
+static inline size_t cpool_round(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static inline bool cpool_is_block(void *memory) {
+    return (char *) memory >= cpool_heap.block_start && (char *) memory < cpool_heap.block_end;
+}
+
+static inline bool cpool_is_byte(void *memory) {
+    return (char *) memory >= cpool_heap.byte_start && (char *) memory < cpool_heap.byte_end;
+}
+
+static inline cpool_chunk_t *cpool_chunk_of(void *memory) {
+    return (cpool_chunk_t *) (cpool_heap.block_start
+                              + ((char *) memory - cpool_heap.block_start) / CPOOL_MALLOC_CHUNK * CPOOL_MALLOC_CHUNK);
+}
+
+/* start of the block an over aligned pointer was carved from, tagged by owner | 1 in the word before it */
+static inline void *cpool_block_of(cpool_chunk_t *chunk, void *memory) {
+    char   *first;
+    size_t stride;
+
+    if (((uintptr_t *) memory)[-1] == ((uintptr_t) &chunk->pool | 1)) {
+        first  = (char *) chunk->pool.start + sizeof(void *);
+        stride = sizeof(void *) + chunk->pool.alignment;
+        memory = first + ((char *) memory - first) / stride * stride;
+    }
+    return memory;
+}
+
+/* mapping header in front of memory, Null if memory didn't come from cpool_huge_allocate */
+static inline cpool_huge_t *cpool_huge_of(void *memory) {
+    cpool_huge_t *huge = (cpool_huge_t *) memory - 1;
+
+    if (((uintptr_t) memory & (CPOOL_MALLOC_ALIGN - 1)) != 0
+        || huge->magic != ((uintptr_t) huge->base ^ CPOOL_MALLOC_MAGIC)
+        || (char *) memory < (char *) huge->base || (char *) memory >= (char *) huge->base + huge->length) {
+        return NULL;
+    }
+    return huge;
+}
+
+void *cpool_malloc(size_t size) {
+    void *memory = NULL;
+
+    cpool_malloc_init();
+
+    if (size <= CPOOL_MALLOC_SMALL) {
+        memory = cpool_small_allocate(cpool_heap.class_index[(size + CPOOL_MALLOC_ALIGN - 1) / CPOOL_MALLOC_ALIGN]);
+    }
+    if (memory == NULL && size <= CPOOL_MALLOC_HUGE) {
+        memory = cpool_mid_allocate(size);
+    }
+    if (memory == NULL) {
+        memory = cpool_huge_allocate(size, CPOOL_MALLOC_ALIGN);
+    }
+
+    return memory;
+}
+
+void cpool_free(void *memory) {
+    cpool_huge_t *huge;
+
+    if (memory == NULL) {
+        return;
+    }
+
+    if (cpool_is_block(memory)) {
+        cpool_chunk_t *chunk = cpool_chunk_of(memory);
+        cpool_small_release(chunk, cpool_block_of(chunk, memory));
+    } else if (cpool_is_byte(memory)) {
+        pool_lock(&cpool_heap.byte_lock);
+        byte_release(memory);
+        pool_unlock(&cpool_heap.byte_lock);
+    } else if ((huge = cpool_huge_of(memory)) != NULL) {
+        /* anything else belongs to another allocator, leave it alone */
+        huge->magic = 0;
+        munmap(huge->base, huge->length);
+    }
+}
+
+void *cpool_calloc(size_t count, size_t size) {
+    void *memory;
+
+    if (size != 0 && count > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    memory = cpool_malloc(count * size);
+    if (memory != NULL && (cpool_is_block(memory) || cpool_is_byte(memory))) {
+        /* directly mapped memory is already zero */
+        memset(memory, 0, count * size);
+    }
+
+    return memory;
+}
+
+void *cpool_realloc(void *memory, size_t size) {
+    void   *resized;
+    size_t usable;
+
+    if (memory == NULL) {
+        return cpool_malloc(size);
+    }
+    if (size == 0) {
+        cpool_free(memory);
+        return NULL;
+    }
+
+    usable = cpool_malloc_usable_size(memory);
+    if (size <= usable) {
+        return memory;
+    }
+
+    resized = cpool_malloc(size);
+    if (resized != NULL) {
+        memcpy(resized, memory, usable);
+        cpool_free(memory);
+    }
+
+    return resized;
+}
+
+int cpool_posix_memalign(void **memory, size_t alignment, size_t size) {
+    char          *block;
+    char          *aligned;
+    cpool_chunk_t *chunk;
+
+    if (memory == NULL || alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+
+    cpool_malloc_init();
+
+    if (alignment <= CPOOL_MALLOC_ALIGN) {
+        aligned = cpool_malloc(size);
+    } else if (alignment - CPOOL_MALLOC_ALIGN <= CPOOL_MALLOC_SMALL
+               && size <= CPOOL_MALLOC_SMALL - (alignment - CPOOL_MALLOC_ALIGN)) {
+        /* compared without adding to size, which would wrap around for huge requests.
+         * over allocate from a size class and tag the word before the aligned pointer */
+        block   = cpool_small_allocate(cpool_heap.class_index[(size + alignment - 1) / CPOOL_MALLOC_ALIGN]);
+        aligned = (block != NULL) ? (char *) cpool_round((uintptr_t) block, alignment) : NULL;
+        if (aligned != block) {
+            chunk = cpool_chunk_of(block);
+            ((uintptr_t *) aligned)[-1] = (uintptr_t) &chunk->pool | 1;
+        }
+        if (aligned == NULL) {
+            aligned = cpool_huge_allocate(size, alignment);
+        }
+    } else {
+        aligned = cpool_huge_allocate(size, alignment);
+    }
+
+    if (aligned == NULL) {
+        return ENOMEM;
+    }
+
+    *memory = aligned;
+    return 0;
+}
+
+void *cpool_aligned_alloc(size_t alignment, size_t size) {
+    void *memory = NULL;
+    int  error   = cpool_posix_memalign(&memory, alignment < sizeof(void *) ? sizeof(void *) : alignment, size);
+
+    if (error != 0) {
+        errno  = error;
+        memory = NULL;
+    }
+    return memory;
+}
+
+size_t cpool_malloc_usable_size(void *memory) {
+    size_t        usable = 0;
+    cpool_chunk_t *chunk;
+    cpool_huge_t  *huge;
+    void          *block;
+
+    if (memory == NULL) {
+        usable = 0;
+    } else if (cpool_is_block(memory)) {
+        chunk  = cpool_chunk_of(memory);
+        block  = cpool_block_of(chunk, memory);
+        usable = chunk->pool.alignment - ((char *) memory - (char *) block);
+    } else if (cpool_is_byte(memory)) {
+        usable = byte_size(memory);
+    } else if ((huge = cpool_huge_of(memory)) != NULL) {
+        usable = huge->length - ((char *) memory - (char *) huge->base);
+    }
+
+    return usable;
+}
+
+static void cpool_atfork_prepare(void) {
+    pool_lock(&cpool_heap.lock);
+    pool_lock(&cpool_heap.byte_lock);
+    for (size_t i = 0; i < CPOOL_MALLOC_CLASSES; i++) {
+        pool_lock(&cpool_heap.classes[i].lock);
+    }
+}
+
+static void cpool_atfork_release(void) {
+    for (size_t i = 0; i < CPOOL_MALLOC_CLASSES; i++) {
+        pool_unlock(&cpool_heap.classes[i].lock);
+    }
+    pool_unlock(&cpool_heap.byte_lock);
+    pool_unlock(&cpool_heap.lock);
+}
+
+static void cpool_malloc_init(void) {
+    size_t reserve = CPOOL_MALLOC_RESERVE;
+    size_t class   = 0;
+    char   *region = MAP_FAILED;
+
+    if (__atomic_load_n(&cpool_heap.ready, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    pool_lock(&cpool_heap.lock);
+    if (!cpool_heap.ready) {
+        for (size_t i = 0; i < sizeof(cpool_heap.class_index); i++) {
+            while (class + 1 < CPOOL_MALLOC_CLASSES && cpool_class_sizes[class] < i * CPOOL_MALLOC_ALIGN) {
+                class++;
+            }
+            cpool_heap.class_index[i] = (unsigned char) class;
+        }
+
+        /* reserve address space only, chunks and arenas are committed as they are carved */
+        while (region == MAP_FAILED && reserve >= CPOOL_MALLOC_ARENA) {
+            region = mmap(NULL, 2 * reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (region == MAP_FAILED) {
+                reserve /= 2;
+            }
+        }
+
+        if (region != MAP_FAILED) {
+            cpool_heap.block_start  = (char *) cpool_round((uintptr_t) region, CPOOL_MALLOC_CHUNK);
+            cpool_heap.block_cursor = cpool_heap.block_start;
+            cpool_heap.block_end    = region + reserve;
+            cpool_heap.byte_start   = region + reserve;
+            cpool_heap.byte_cursor  = cpool_heap.byte_start;
+            cpool_heap.byte_end     = region + 2 * reserve;
+        }
+
+        __atomic_store_n(&cpool_heap.ready, 1, __ATOMIC_RELEASE);
+    }
+    pool_unlock(&cpool_heap.lock);
+}
+
+/* pthread_atfork can allocate, so register from a constructor rather than under the heap lock */
+__attribute__((constructor)) static void cpool_malloc_register(void) {
+    cpool_malloc_init();
+
+    if (!cpool_heap.registered) {
+        pthread_key_create(&cpool_heap.key, cpool_cache_finish);
+        pthread_atfork(cpool_atfork_prepare, cpool_atfork_release, cpool_atfork_release);
+        __atomic_store_n(&cpool_heap.registered, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static cpool_chunk_t *cpool_chunk_carve(size_t class) {
+    cpool_chunk_t *chunk = NULL;
+    char          *base  = NULL;
+
+    pool_lock(&cpool_heap.lock);
+    if (cpool_heap.block_cursor != NULL && cpool_heap.block_cursor + CPOOL_MALLOC_CHUNK <= cpool_heap.block_end) {
+        base = cpool_heap.block_cursor;
+        if (mprotect(base, CPOOL_MALLOC_CHUNK, PROT_READ | PROT_WRITE) == 0) {
+            cpool_heap.block_cursor += CPOOL_MALLOC_CHUNK;
+        } else {
+            base = NULL;
+        }
+    }
+    pool_unlock(&cpool_heap.lock);
+
+    if (base != NULL) {
+        /* offset blocks by a header so payloads land on 16 byte boundaries */
+        chunk = (cpool_chunk_t *) base;
+        block_pool_init(&chunk->pool, cpool_class_sizes[class],
+                        base + cpool_round(sizeof(cpool_chunk_t), CPOOL_MALLOC_ALIGN) + CPOOL_MALLOC_ALIGN - sizeof(void *),
+                        base + CPOOL_MALLOC_CHUNK);
+        chunk->next    = NULL;
+        chunk->class   = class;
+        chunk->partial = false;
+    }
+
+    return chunk;
+}
+
+/* class lock must be held */
+static void *cpool_class_allocate(cpool_class_t *class, size_t index) {
+    void *memory = NULL;
+
+    while (memory == NULL) {
+        if (class->current != NULL && (memory = block_allocate(&class->current->pool)) != NULL) {
+            break;
+        }
+
+        if (class->partial != NULL) {
+            class->current          = class->partial;
+            class->partial          = class->current->next;
+            class->current->partial = false;
+        } else if ((class->current = cpool_chunk_carve(index)) == NULL) {
+            break;
+        }
+    }
+
+    return memory;
+}
+
+/* class lock must be held */
+static void cpool_class_release(cpool_class_t *class, cpool_chunk_t *chunk, void *memory) {
+    block_release(memory);
+
+    if (chunk != class->current && !chunk->partial) {
+        chunk->next    = class->partial;
+        chunk->partial = true;
+        class->partial = chunk;
+    }
+}
+
+static void cpool_cache_flush(size_t index, unsigned keep) {
+    cpool_class_t *class = &cpool_heap.classes[index];
+    void          *memory;
+
+    pool_lock(&class->lock);
+    while (cpool_cache.count[index] > keep) {
+        memory = cpool_cache.head[index];
+        cpool_cache.head[index] = *(void **) memory;
+        cpool_cache.count[index]--;
+        cpool_class_release(class, cpool_chunk_of(memory), memory);
+    }
+    pool_unlock(&class->lock);
+}
+
+static void cpool_cache_finish(void *cache) {
+    (void) cache; /* the key only signals thread exit, the cache is thread local */
+    for (size_t i = 0; i < CPOOL_MALLOC_CLASSES; i++) {
+        cpool_cache_flush(i, 0);
+    }
+    cpool_cache.state = CPOOL_CACHE_FINISHED;
+}
+
+static bool cpool_cache_ready(void) {
+    /* allocations before the constructor ran go straight to the class */
+    if (!__atomic_load_n(&cpool_heap.registered, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    if (cpool_cache.state == CPOOL_CACHE_UNUSED) {
+        /* set first, registering the destructor may allocate */
+        cpool_cache.state = CPOOL_CACHE_ACTIVE;
+        pthread_setspecific(cpool_heap.key, &cpool_cache);
+    }
+    return cpool_cache.state == CPOOL_CACHE_ACTIVE;
+}
+
+static void *cpool_small_allocate(size_t index) {
+    cpool_class_t *class  = &cpool_heap.classes[index];
+    void          *memory = NULL;
+
+    if (!cpool_cache_ready()) {
+        pool_lock(&class->lock);
+        memory = cpool_class_allocate(class, index);
+        pool_unlock(&class->lock);
+        return memory;
+    }
+
+    if (cpool_cache.count[index] == 0) {
+        pool_lock(&class->lock);
+        while (cpool_cache.count[index] < CPOOL_MALLOC_CACHE / 2 && (memory = cpool_class_allocate(class, index)) != NULL) {
+            *(void **) memory = cpool_cache.head[index];
+            cpool_cache.head[index] = memory;
+            cpool_cache.count[index]++;
+        }
+        pool_unlock(&class->lock);
+    }
+
+    if (cpool_cache.count[index] > 0) {
+        memory = cpool_cache.head[index];
+        cpool_cache.head[index] = *(void **) memory;
+        cpool_cache.count[index]--;
+    }
+
+    return memory;
+}
+
+static void cpool_small_release(cpool_chunk_t *chunk, void *memory) {
+    cpool_class_t *class = &cpool_heap.classes[chunk->class];
+
+    if (!cpool_cache_ready()) {
+        pool_lock(&class->lock);
+        cpool_class_release(class, chunk, memory);
+        pool_unlock(&class->lock);
+        return;
+    }
+
+    *(void **) memory = cpool_cache.head[chunk->class];
+    cpool_cache.head[chunk->class] = memory;
+    if (++cpool_cache.count[chunk->class] >= CPOOL_MALLOC_CACHE) {
+        cpool_cache_flush(chunk->class, CPOOL_MALLOC_CACHE / 2);
+    }
+}
+
+static void *cpool_mid_allocate(size_t size) {
+    void        *memory = NULL;
+    byte_pool_t *pool;
+    size_t      arenas;
+    char        *base;
+
+    /* keep every block a multiple of 16 so headers and payloads stay aligned */
+    size = cpool_round(size ? size : 1, CPOOL_MALLOC_ALIGN);
+
+    pool_lock(&cpool_heap.byte_lock);
+    arenas = (cpool_heap.byte_cursor - cpool_heap.byte_start) / CPOOL_MALLOC_ARENA;
+    for (size_t i = 0; i < arenas && memory == NULL; i++) {
+        pool = (byte_pool_t *) (cpool_heap.byte_start + ((cpool_heap.byte_search + i) % arenas) * CPOOL_MALLOC_ARENA);
+        if (pool->capacity >= size && (memory = byte_allocate(pool, size)) != NULL) {
+            cpool_heap.byte_search = (cpool_heap.byte_search + i) % arenas;
+        }
+    }
+
+    if (memory == NULL && cpool_heap.byte_cursor != NULL
+        && cpool_heap.byte_cursor + CPOOL_MALLOC_ARENA <= cpool_heap.byte_end
+        && mprotect(cpool_heap.byte_cursor, CPOOL_MALLOC_ARENA, PROT_READ | PROT_WRITE) == 0) {
+        base = cpool_heap.byte_cursor;
+        pool = (byte_pool_t *) base;
+        byte_pool_init(pool, base + cpool_round(sizeof(byte_pool_t), CPOOL_MALLOC_ALIGN),
+                       CPOOL_MALLOC_ARENA - cpool_round(sizeof(byte_pool_t), CPOOL_MALLOC_ALIGN));
+        cpool_heap.byte_cursor += CPOOL_MALLOC_ARENA;
+        cpool_heap.byte_search = arenas;
+        memory = byte_allocate(pool, size);
+    }
+    pool_unlock(&cpool_heap.byte_lock);
+
+    return memory;
+}
+
+static void *cpool_huge_allocate(size_t size, size_t alignment) {
+    size_t       page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t       length;
+    char         *base;
+    char         *memory;
+    cpool_huge_t *huge;
+
+    if (size > SIZE_MAX - alignment - sizeof(cpool_huge_t) - page) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    length = cpool_round(size + cpool_round(sizeof(cpool_huge_t), CPOOL_MALLOC_ALIGN)
+                         + (alignment > CPOOL_MALLOC_ALIGN ? alignment : 0), page);
+    base   = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    memory = (char *) cpool_round((uintptr_t) (base + sizeof(cpool_huge_t)), alignment);
+    huge   = (cpool_huge_t *) memory - 1;
+    huge->base   = base;
+    huge->length = length;
+    huge->magic  = (uintptr_t) base ^ CPOOL_MALLOC_MAGIC;
+
+    return memory;
+}
+
+#ifdef CPOOL_MALLOC_OVERRIDE
+
+void *malloc(size_t size) {
+    return cpool_malloc(size);
+}
+
+void free(void *memory) {
+    cpool_free(memory);
+}
+
+void *calloc(size_t count, size_t size) {
+    return cpool_calloc(count, size);
+}
+
+void *realloc(void *memory, size_t size) {
+    return cpool_realloc(memory, size);
+}
+
+void *reallocarray(void *memory, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return cpool_realloc(memory, count * size);
+}
+
+int posix_memalign(void **memory, size_t alignment, size_t size) {
+    return cpool_posix_memalign(memory, alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return cpool_aligned_alloc(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    return cpool_aligned_alloc(alignment, size);
+}
+
+void *valloc(size_t size) {
+    return cpool_aligned_alloc((size_t) sysconf(_SC_PAGESIZE), size);
+}
+
+void *pvalloc(size_t size) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    return cpool_aligned_alloc(page, cpool_round(size, page));
+}
+
+size_t malloc_usable_size(void *memory) {
+    return cpool_malloc_usable_size(memory);
+}
+
+#endif
@@ -0,0 +1,197 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_chain.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+static void pool_chain_append(pool_chain_t *chain, pool_tier_t *tier);
+
+static bool pool_chain_insert(pool_chain_t *chain, pool_tier_t *tier);
+
+void pool_chain_init(pool_chain_t *chain, pool_tier_t **index, size_t capacity) {
+    if (chain != NULL && (index != NULL || capacity == 0)) {
+        chain->first    = NULL;
+        chain->last     = NULL;
+        chain->system   = NULL;
+        chain->index    = index;
+        chain->count    = 0;
+        chain->capacity = capacity;
+        chain->spills   = 0;
+    }
+}
+
+int pool_chain_add_block(pool_chain_t *chain, pool_tier_t *tier, block_pool_t *pool) {
+    if (chain == NULL || tier == NULL || !block_pool_is_valid(pool)) {
+        return false;
+    }
+
+    tier->type     = POOL_TIER_BLOCK;
+    tier->pool     = pool;
+    tier->start    = pool->start;
+    tier->end      = pool->end;
+    tier->size     = pool->alignment;
+    tier->allocate = NULL;
+    tier->release  = NULL;
+
+    if (!pool_chain_insert(chain, tier)) {
+        return false;
+    }
+    pool_chain_append(chain, tier);
+    return true;
+}
+
+int pool_chain_add_byte(pool_chain_t *chain, pool_tier_t *tier, byte_pool_t *pool) {
+    if (chain == NULL || tier == NULL || !byte_pool_is_valid(pool)) {
+        return false;
+    }
+
+    tier->type     = POOL_TIER_BYTE;
+    tier->pool     = pool;
+    tier->start    = pool->start;
+    tier->end      = pool->end;
+    tier->size     = SIZE_MAX;
+    tier->allocate = NULL;
+    tier->release  = NULL;
+
+    if (!pool_chain_insert(chain, tier)) {
+        return false;
+    }
+    pool_chain_append(chain, tier);
+    return true;
+}
+
+int pool_chain_add_system(pool_chain_t *chain, pool_tier_t *tier,
+                          void *(*allocate)(size_t), void (*release)(void *)) {
+    if (chain == NULL || tier == NULL || allocate == NULL || release == NULL || chain->system != NULL) {
+        return false;
+    }
+
+    tier->type     = POOL_TIER_SYSTEM;
+    tier->pool     = NULL;
+    tier->start    = NULL;
+    tier->end      = NULL;
+    tier->size     = SIZE_MAX;
+    tier->allocate = allocate;
+    tier->release  = release;
+
+    chain->system = tier;
+    pool_chain_append(chain, tier);
+    return true;
+}
+
+void *pool_chain_allocate(pool_chain_t *chain, size_t size) {
+    void        *return_ptr = NULL;
+    pool_tier_t *tier;
+    bool        spilled     = false;
+
+    if (chain != NULL && size > 0) {
+        for (tier = chain->first; tier != NULL && return_ptr == NULL; tier = tier->next) {
+            if (size > tier->size) {
+                continue;
+            }
+
+            switch (tier->type) {
+                case POOL_TIER_BLOCK:
+                    return_ptr = block_allocate(tier->pool);
+                    break;
+                case POOL_TIER_BYTE:
+                    return_ptr = byte_allocate(tier->pool, size);
+                    break;
+                default:
+                    return_ptr = tier->allocate(size);
+                    break;
+            }
+
+            if (return_ptr == NULL) {
+                spilled = true;
+            }
+        }
+
+        if (return_ptr != NULL && spilled) {
+            __atomic_add_fetch(&chain->spills, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    return return_ptr;
+}
+
+void pool_chain_release(pool_chain_t *chain, void *memory) {
+    pool_tier_t *tier = pool_chain_owner(chain, memory);
+
+    if (tier != NULL && memory != NULL) {
+        switch (tier->type) {
+            case POOL_TIER_BLOCK:
+                block_release(memory);
+                break;
+            case POOL_TIER_BYTE:
+                byte_release(memory);
+                break;
+            default:
+                tier->release(memory);
+                break;
+        }
+    }
+}
+
+pool_tier_t *pool_chain_owner(pool_chain_t *chain, void *memory) {
+    size_t low  = 0;
+    size_t high;
+    size_t middle;
+
+    if (chain == NULL) {
+        return NULL;
+    }
+
+    /* last tier starting at or below memory */
+    high = chain->count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (chain->index[middle]->start <= memory) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low > 0 && memory < chain->index[low - 1]->end) {
+        return chain->index[low - 1];
+    }
+    return chain->system;
+}
+
+static void pool_chain_append(pool_chain_t *chain, pool_tier_t *tier) {
+    tier->next = NULL;
+    if (chain->last != NULL) {
+        chain->last->next = tier;
+    } else {
+        chain->first = tier;
+    }
+    chain->last = tier;
+}
+
+/* insert tier into the address index, rejecting overlapping ranges */
+static bool pool_chain_insert(pool_chain_t *chain, pool_tier_t *tier) {
+    size_t position = chain->count;
+
+    if (chain->count >= chain->capacity) {
+        return false;
+    }
+
+    while (position > 0 && chain->index[position - 1]->start > tier->start) {
+        position--;
+    }
+
+    if ((position > 0 && chain->index[position - 1]->end > tier->start)
+        || (position < chain->count && chain->index[position]->start < tier->end)) {
+        return false;
+    }
+
+    for (size_t i = chain->count; i > position; i--) {
+        chain->index[i] = chain->index[i - 1];
+    }
+    chain->index[position] = tier;
+    chain->count++;
+    return true;
+}
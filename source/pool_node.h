@@ -0,0 +1,95 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_NODE_H
+#define MEMORY_POOL_NODE_H
+
+/* private lock-free node helpers shared by the pooled containers */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "block_pool.h"
+
+/*
+ * Links are 64 bit words holding a 32 bit node number, one based so zero
+ * is null, and a 32 bit tag bumped by every write. A compare and swap
+ * against a stale link then fails even if the same node came back, and
+ * nodes stay inside the container until trimmed, so reading a node that
+ * was popped under our feet is harmless.
+ */
+typedef struct pool_node_t {
+    volatile uint64_t next;
+    void *volatile    value;
+} pool_node_t;
+
+static inline uint32_t pool_node_number(uint64_t link) {
+    return (uint32_t) link;
+}
+
+/* link to number, tagged one past the link it replaces */
+static inline uint64_t pool_node_link(uint32_t number, uint64_t replaces) {
+    return ((replaces >> 32) + 1) << 32 | number;
+}
+
+static inline pool_node_t *pool_node_at(block_pool_t *pool, uint32_t number) {
+    return (pool_node_t *) ((char *) pool->start + (number - 1) * (pool->alignment + sizeof(void *)) + sizeof(void *));
+}
+
+static inline uint32_t pool_node_number_of(block_pool_t *pool, pool_node_t *node) {
+    return (uint32_t) (((char *) node - sizeof(void *) - (char *) pool->start) / (pool->alignment + sizeof(void *)) + 1);
+}
+
+/* push node onto a Treiber stack */
+static inline void pool_node_push(block_pool_t *pool, volatile uint64_t *top, pool_node_t *node) {
+    uint64_t old    = __atomic_load_n(top, __ATOMIC_ACQUIRE);
+    uint32_t number = pool_node_number_of(pool, node);
+
+    do {
+        node->next = pool_node_link(pool_node_number(old), node->next);
+    } while (!__atomic_compare_exchange_n(top, &old, pool_node_link(number, old), true,
+                                          __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+/* pop node from a Treiber stack, Null if empty */
+static inline pool_node_t *pool_node_pop(block_pool_t *pool, volatile uint64_t *top) {
+    uint64_t    old = __atomic_load_n(top, __ATOMIC_ACQUIRE);
+    pool_node_t *node;
+
+    do {
+        if (pool_node_number(old) == 0) {
+            return NULL;
+        }
+        node = pool_node_at(pool, pool_node_number(old));
+    } while (!__atomic_compare_exchange_n(top, &old, pool_node_link(pool_node_number(node->next), old), true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    return node;
+}
+
+/* recycled node, or a new one from the pool */
+static inline pool_node_t *pool_node_allocate(block_pool_t *pool, volatile uint64_t *free) {
+    pool_node_t *node = pool_node_pop(pool, free);
+
+    if (node == NULL) {
+        node = block_allocate(pool);
+    }
+    if (node != NULL) {
+        node->next = pool_node_link(0, node->next);
+    }
+    return node;
+}
+
+/* return recycled nodes to the pool, returns the number released */
+static inline size_t pool_node_trim(block_pool_t *pool, volatile uint64_t *free) {
+    pool_node_t *node;
+    size_t      count = 0;
+
+    while ((node = pool_node_pop(pool, free)) != NULL) {
+        block_release(node);
+        count++;
+    }
+    return count;
+}
+
+#endif //MEMORY_POOL_NODE_H
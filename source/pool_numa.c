@@ -0,0 +1,217 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* getcpu */
+#endif
+
+#include "pool_numa.h"
+#include "pool_sync.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(SYS_mbind) && defined(SYS_set_mempolicy)
+#define POOL_NUMA_SUPPORTED 1
+#endif
+#endif
+
+/* from linux/mempolicy.h, numaif.h is only installed with libnuma */
+#define POOL_NUMA_MPOL_PREFERRED 1
+#define POOL_NUMA_MPOL_BIND      2
+#define POOL_NUMA_MPOL_MF_MOVE   (1 << 1)
+
+#define POOL_NUMA_MASK_BITS (8 * sizeof(unsigned long))
+
+static size_t pool_numa_local(pool_numa_set_t *set);
+
+size_t pool_numa_nodes(void) {
+    size_t nodes = 1;
+
+#ifdef POOL_NUMA_SUPPORTED
+    FILE          *file = fopen("/sys/devices/system/node/online", "r");
+    unsigned long node;
+    int           separator;
+
+    /* ranges like 0-1,3 so the last number is the highest node */
+    if (file != NULL) {
+        while (fscanf(file, "%lu", &node) == 1) {
+            nodes     = node + 1;
+            separator = fgetc(file);
+            if (separator != '-' && separator != ',') {
+                break;
+            }
+        }
+        fclose(file);
+    }
+#endif
+
+    return nodes;
+}
+
+size_t pool_numa_current(void) {
+    unsigned int cpu  = 0;
+    unsigned int node = 0;
+
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 29)
+    /* vdso, no system call */
+    if (getcpu(&cpu, &node) != 0) {
+        node = 0;
+    }
+#elif defined(__linux__) && defined(SYS_getcpu)
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) {
+        node = 0;
+    }
+#endif
+
+    (void) cpu;
+    return node;
+}
+
+int pool_numa_bind(void *memory, size_t size, size_t node) {
+    int result = false;
+
+#ifdef POOL_NUMA_SUPPORTED
+    unsigned long mask[(POOL_NUMA_MAX + POOL_NUMA_MASK_BITS - 1) / POOL_NUMA_MASK_BITS] = {0};
+    size_t        page = (size_t) sysconf(_SC_PAGESIZE);
+    uintptr_t     first;
+    uintptr_t     last;
+
+    if (memory != NULL && node < POOL_NUMA_MAX && pool_numa_nodes() > 1) {
+        first = ((uintptr_t) memory + page - 1) & ~(uintptr_t) (page - 1);
+        last  = ((uintptr_t) memory + size) & ~(uintptr_t) (page - 1);
+
+        if (first < last) {
+            mask[node / POOL_NUMA_MASK_BITS] = 1ul << (node % POOL_NUMA_MASK_BITS);
+            /* the kernel reads one bit less than maxnode */
+            result = syscall(SYS_mbind, first, last - first, POOL_NUMA_MPOL_BIND, mask,
+                             sizeof(mask) * 8 + 1, POOL_NUMA_MPOL_MF_MOVE) == 0;
+        }
+    }
+#else
+    (void) memory;
+    (void) size;
+    (void) node;
+#endif
+
+    return result;
+}
+
+int pool_numa_prefer(size_t node) {
+    int result = false;
+
+#ifdef POOL_NUMA_SUPPORTED
+    unsigned long mask[(POOL_NUMA_MAX + POOL_NUMA_MASK_BITS - 1) / POOL_NUMA_MASK_BITS] = {0};
+
+    if (node < POOL_NUMA_MAX && pool_numa_nodes() > 1) {
+        mask[node / POOL_NUMA_MASK_BITS] = 1ul << (node % POOL_NUMA_MASK_BITS);
+        result = syscall(SYS_set_mempolicy, POOL_NUMA_MPOL_PREFERRED, mask, sizeof(mask) * 8 + 1) == 0;
+    }
+#else
+    (void) node;
+#endif
+
+    return result;
+}
+
+void pool_numa_set_init(pool_numa_set_t *set) {
+    if (set != NULL) {
+        for (size_t node = 0; node < POOL_NUMA_MAX; node++) {
+            set->nodes[node].block     = NULL;
+            set->nodes[node].byte      = NULL;
+            set->nodes[node].byte_lock = 0;
+        }
+        set->count  = 0;
+        set->remote = 0;
+    }
+}
+
+int pool_numa_set_add(pool_numa_set_t *set, size_t node, block_pool_t *block, byte_pool_t *byte) {
+    if (set == NULL || node >= POOL_NUMA_MAX || (!block_pool_is_valid(block) && !byte_pool_is_valid(byte))) {
+        return false;
+    }
+
+    /* threads on every node allocate from and release into each pool */
+    if (block_pool_is_valid(block)) {
+        block_pool_mark_shared(block);
+        set->nodes[node].block = block;
+    }
+    if (byte_pool_is_valid(byte)) {
+        set->nodes[node].byte = byte;
+    }
+
+    if (node >= set->count) {
+        set->count = node + 1;
+    }
+    return true;
+}
+
+void *pool_numa_block_allocate(pool_numa_set_t *set) {
+    void   *return_ptr = NULL;
+    size_t local;
+    size_t node;
+
+    if (set != NULL && set->count > 0) {
+        local = pool_numa_local(set);
+        for (size_t i = 0; i < set->count && return_ptr == NULL; i++) {
+            node = (local + i) % set->count;
+            if (set->nodes[node].block != NULL) {
+                return_ptr = block_allocate(set->nodes[node].block);
+                if (return_ptr != NULL && i > 0) {
+                    __atomic_add_fetch(&set->remote, 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+    }
+
+    return return_ptr;
+}
+
+void *pool_numa_byte_allocate(pool_numa_set_t *set, size_t size) {
+    void   *return_ptr = NULL;
+    size_t local;
+    size_t node;
+
+    if (set != NULL && set->count > 0) {
+        local = pool_numa_local(set);
+        for (size_t i = 0; i < set->count && return_ptr == NULL; i++) {
+            node = (local + i) % set->count;
+            if (set->nodes[node].byte != NULL) {
+                pool_lock(&set->nodes[node].byte_lock);
+                return_ptr = byte_allocate(set->nodes[node].byte, size);
+                pool_unlock(&set->nodes[node].byte_lock);
+                if (return_ptr != NULL && i > 0) {
+                    __atomic_add_fetch(&set->remote, 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+    }
+
+    return return_ptr;
+}
+
+void pool_numa_byte_release(pool_numa_set_t *set, void *memory) {
+    byte_pool_t *byte;
+
+    if (set != NULL && memory != NULL) {
+        for (size_t node = 0; node < set->count; node++) {
+            byte = set->nodes[node].byte;
+            if (byte != NULL && memory > byte->start && memory < byte->end) {
+                pool_lock(&set->nodes[node].byte_lock);
+                byte_release(memory);
+                pool_unlock(&set->nodes[node].byte_lock);
+                break;
+            }
+        }
+    }
+}
+
+/* calling thread's node, skipping the lookup when there is only one */
+static size_t pool_numa_local(pool_numa_set_t *set) {
+    return (set->count > 1) ? pool_numa_current() % set->count : 0;
+}
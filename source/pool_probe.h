@@ -0,0 +1,29 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_PROBE_H
+#define MEMORY_POOL_PROBE_H
+
+/*
+ * private USDT probe points under the cpool provider. Built with
+ * CPOOL_USDT each probe is a single nop plus a note in the binary that
+ * bpftrace, perf or SystemTap patch at attach time, otherwise they
+ * compile away. Arguments are kept to values at hand or a subtraction
+ * away, so a detached probe costs little more than its nop.
+ */
+
+#if defined(CPOOL_USDT)
+#include <sys/sdt.h>
+#define POOL_PROBE1(name, a)             DTRACE_PROBE1(cpool, name, a)
+#define POOL_PROBE2(name, a, b)          DTRACE_PROBE2(cpool, name, a, b)
+#define POOL_PROBE3(name, a, b, c)       DTRACE_PROBE3(cpool, name, a, b, c)
+#define POOL_PROBE4(name, a, b, c, d)    DTRACE_PROBE4(cpool, name, a, b, c, d)
+#else
+#define POOL_PROBE1(name, a)             ((void) 0)
+#define POOL_PROBE2(name, a, b)          ((void) 0)
+#define POOL_PROBE3(name, a, b, c)       ((void) 0)
+#define POOL_PROBE4(name, a, b, c, d)    ((void) 0)
+#endif
+
+#endif //MEMORY_POOL_PROBE_H
@@ -0,0 +1,374 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_profile.h"
+#include "pool_sync.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#define POOL_PROFILE_REMOVED ((uintptr_t) 1)
+#define POOL_PROFILE_NONE    ((size_t) -1)
+
+__thread int64_t pool_profile_countdown = 0;
+
+volatile size_t pool_profile_live = 0;
+
+static pool_profile_t *pool_profile_active = NULL;
+
+static __thread uint64_t pool_profile_seed = 0;
+
+static __thread int pool_profile_busy = 0;
+
+static size_t pool_profile_interval(size_t rate);
+
+static uint64_t pool_profile_weight(size_t size, size_t rate);
+
+static uint32_t pool_profile_stack(void **frames);
+
+static size_t pool_profile_site(pool_profile_t *profile, const void *pool, void **frames, uint32_t depth);
+
+static size_t pool_profile_find(pool_profile_t *profile, uintptr_t address, bool reuse);
+
+static void pool_profile_remove(pool_profile_t *profile, size_t index);
+
+static size_t pool_profile_next(pool_profile_t *profile, uint64_t bytes, size_t index);
+
+void pool_profile_init(pool_profile_t *profile, pool_profile_site_t *sites, size_t site_capacity,
+                       pool_profile_sample_t *samples, size_t sample_capacity, size_t rate) {
+    if (profile != NULL && sites != NULL && site_capacity > 0 && samples != NULL && sample_capacity > 0) {
+        memset(sites, 0, site_capacity * sizeof(pool_profile_site_t));
+        memset(samples, 0, sample_capacity * sizeof(pool_profile_sample_t));
+
+        profile->sites           = sites;
+        profile->site_capacity   = site_capacity;
+        profile->samples         = samples;
+        profile->sample_capacity = sample_capacity;
+        profile->rate            = (rate > 0) ? rate : POOL_PROFILE_RATE;
+        profile->live            = 0;
+        profile->dropped         = 0;
+        profile->lock            = 0;
+    }
+}
+
+void pool_profile_attach(pool_profile_t *profile) {
+#if defined(__GLIBC__)
+    void *frame;
+
+    /* the first backtrace loads the unwinder, get that allocation done outside of a pool */
+    backtrace(&frame, 1);
+#endif
+    __atomic_store_n(&pool_profile_active, profile, __ATOMIC_RELEASE);
+    __atomic_store_n(&pool_profile_live, (profile != NULL) ? profile->live : 0, __ATOMIC_RELEASE);
+}
+
+void pool_profile_sample(const void *pool, const void *address, size_t size) {
+    pool_profile_t        *profile = __atomic_load_n(&pool_profile_active, __ATOMIC_ACQUIRE);
+    pool_profile_sample_t *sample;
+    void                  *frames[POOL_PROFILE_DEPTH];
+    uint32_t              depth;
+    uint64_t              weight;
+    size_t                site;
+    size_t                index;
+
+    if (profile == NULL || pool_profile_busy) {
+        /* check back now and then in case a profile gets attached */
+        pool_profile_countdown = POOL_PROFILE_RATE;
+        return;
+    }
+
+    weight                 = pool_profile_weight(size, profile->rate);
+    pool_profile_countdown = (int64_t) pool_profile_interval(profile->rate);
+
+    if (address == NULL) {
+        return;
+    }
+
+    pool_profile_busy = 1;
+    depth             = pool_profile_stack(frames);
+
+    pool_lock(&profile->lock);
+    site  = pool_profile_site(profile, pool, frames, depth);
+    index = pool_profile_find(profile, (uintptr_t) address, true);
+    if (site != POOL_PROFILE_NONE && index != POOL_PROFILE_NONE) {
+        profile->sites[site].live_bytes  += weight;
+        profile->sites[site].live_count  += 1;
+        profile->sites[site].total_bytes += weight;
+
+        sample         = &profile->samples[index];
+        sample->weight = weight;
+        sample->site   = site;
+        __atomic_store_n(&sample->address, (uintptr_t) address, __ATOMIC_RELEASE);
+        profile->live++;
+        __atomic_store_n(&pool_profile_live, profile->live, __ATOMIC_RELEASE);
+    } else {
+        profile->dropped++;
+    }
+    pool_unlock(&profile->lock);
+
+    pool_profile_busy = 0;
+}
+
+void pool_profile_release(const void *address) {
+    pool_profile_t        *profile = __atomic_load_n(&pool_profile_active, __ATOMIC_ACQUIRE);
+    pool_profile_sample_t *sample;
+    pool_profile_site_t   *site;
+    size_t                index;
+
+    /* look without the lock first, almost every release is of an allocation that was never sampled */
+    if (profile == NULL || address == NULL
+        || pool_profile_find(profile, (uintptr_t) address, false) == POOL_PROFILE_NONE) {
+        return;
+    }
+
+    pool_lock(&profile->lock);
+    index = pool_profile_find(profile, (uintptr_t) address, false);
+    if (index != POOL_PROFILE_NONE) {
+        sample = &profile->samples[index];
+        site   = &profile->sites[sample->site];
+        site->live_bytes -= sample->weight;
+        site->live_count -= 1;
+
+        pool_profile_remove(profile, index);
+        profile->live--;
+        __atomic_store_n(&pool_profile_live, profile->live, __ATOMIC_RELEASE);
+    }
+    pool_unlock(&profile->lock);
+}
+
+void pool_profile_move(const void *from, const void *to) {
+    pool_profile_t        *profile = __atomic_load_n(&pool_profile_active, __ATOMIC_ACQUIRE);
+    pool_profile_sample_t sample;
+    size_t                index;
+
+    if (profile == NULL || from == NULL || to == NULL || from == to
+        || pool_profile_find(profile, (uintptr_t) from, false) == POOL_PROFILE_NONE) {
+        return;
+    }
+
+    pool_lock(&profile->lock);
+    index = pool_profile_find(profile, (uintptr_t) from, false);
+    if (index != POOL_PROFILE_NONE) {
+        /* rehome the sample so lookups by its new address probe from the right slot */
+        sample = profile->samples[index];
+        pool_profile_remove(profile, index);
+
+        index = pool_profile_find(profile, (uintptr_t) to, true);
+        profile->samples[index].weight = sample.weight;
+        profile->samples[index].site   = sample.site;
+        __atomic_store_n(&profile->samples[index].address, (uintptr_t) to, __ATOMIC_RELEASE);
+    }
+    pool_unlock(&profile->lock);
+}
+
+size_t pool_profile_read(pool_profile_t *profile, pool_profile_site_t *sites, size_t max) {
+    size_t   count = 0;
+    size_t   index = POOL_PROFILE_NONE;
+    uint64_t bytes = UINT64_MAX;
+
+    if (profile == NULL || sites == NULL) {
+        return 0;
+    }
+
+    pool_lock(&profile->lock);
+    while (count < max && (index = pool_profile_next(profile, bytes, index)) != POOL_PROFILE_NONE) {
+        sites[count++] = profile->sites[index];
+        bytes          = profile->sites[index].live_bytes;
+    }
+    pool_unlock(&profile->lock);
+
+    return count;
+}
+
+size_t pool_profile_dump(pool_profile_t *profile, int fd) {
+    size_t count = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    pool_profile_site_t site;
+    char                line[128];
+    int                 length;
+    size_t              index = POOL_PROFILE_NONE;
+    uint64_t            bytes = UINT64_MAX;
+
+    if (profile == NULL || fd < 0) {
+        return 0;
+    }
+
+    for (;;) {
+        /* copy the site out so the lock isn't held while writing */
+        pool_lock(&profile->lock);
+        index = pool_profile_next(profile, bytes, index);
+        if (index != POOL_PROFILE_NONE) {
+            site = profile->sites[index];
+        }
+        pool_unlock(&profile->lock);
+
+        if (index == POOL_PROFILE_NONE) {
+            break;
+        }
+        bytes = site.live_bytes;
+
+        if (site.live_count > 0) {
+            length = snprintf(line, sizeof(line), "%llu live bytes in %llu samples from pool %p (%llu total)\n",
+                              (unsigned long long) site.live_bytes, (unsigned long long) site.live_count,
+                              site.pool, (unsigned long long) site.total_bytes);
+            if (length > 0 && write(fd, line, (size_t) length) < 0) {
+                break;
+            }
+#if defined(__GLIBC__)
+            backtrace_symbols_fd(site.frames, (int) site.depth, fd);
+#else
+            for (uint32_t i = 0; i < site.depth; i++) {
+                length = snprintf(line, sizeof(line), "%p\n", site.frames[i]);
+                if (length > 0 && write(fd, line, (size_t) length) < 0) {
+                    break;
+                }
+            }
+#endif
+            count++;
+        }
+    }
+#else
+    (void) profile;
+    (void) fd;
+#endif
+    return count;
+}
+
+/* bytes to the next sample, exponential with mean rate so sampling is a poisson process over bytes */
+static size_t pool_profile_interval(size_t rate) {
+    uint64_t x = pool_profile_seed;
+
+    if (x == 0) {
+        x = pool_clock() ^ (uintptr_t) &pool_profile_seed;
+        x = (x != 0) ? x : 0x9e3779b97f4a7c15ull;
+    }
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    pool_profile_seed = x;
+
+    /* uniform over (0, 1], never zero so the log stays finite */
+    return 1 + (size_t) (-log((double) ((x >> 11) + 1) * 0x1p-53) * (double) rate);
+}
+
+/* bytes a sample of size stands for, exponential intervals pick it with probability 1 - exp(-size / rate) */
+static uint64_t pool_profile_weight(size_t size, size_t rate) {
+    if (size == 0) {
+        return rate;
+    }
+    return (uint64_t) ((double) size / -expm1(-(double) size / (double) rate) + 0.5);
+}
+
+static uint32_t pool_profile_stack(void **frames) {
+#if defined(__GLIBC__)
+    void *stack[POOL_PROFILE_DEPTH + 1];
+    int  depth = backtrace(stack, POOL_PROFILE_DEPTH + 1);
+
+    /* leave out the profiler's own frame */
+    if (depth <= 1) {
+        return 0;
+    }
+    memcpy(frames, stack + 1, (size_t) (depth - 1) * sizeof(void *));
+    return (uint32_t) depth - 1;
+#else
+    frames[0] = __builtin_return_address(0);
+    return 1;
+#endif
+}
+
+/* index of the site for pool and stack, adding it if there is room */
+static size_t pool_profile_site(pool_profile_t *profile, const void *pool, void **frames, uint32_t depth) {
+    uint64_t            hash = 0xcbf29ce484222325ull ^ (uintptr_t) pool;
+    pool_profile_site_t *site;
+    size_t              index;
+
+    for (uint32_t i = 0; i < depth; i++) {
+        hash = (hash ^ (uintptr_t) frames[i]) * 0x100000001b3ull;
+    }
+    hash = (hash != 0) ? hash : 1;
+
+    index = hash % profile->site_capacity;
+    for (size_t probe = 0; probe < profile->site_capacity; probe++) {
+        site = &profile->sites[index];
+        if (site->hash == 0) {
+            site->hash  = hash;
+            site->pool  = pool;
+            site->depth = depth;
+            memcpy(site->frames, frames, depth * sizeof(void *));
+            return index;
+        }
+        if (site->hash == hash && site->pool == pool && site->depth == depth
+            && memcmp(site->frames, frames, depth * sizeof(void *)) == 0) {
+            return index;
+        }
+        index = (index + 1 < profile->site_capacity) ? index + 1 : 0;
+    }
+
+    return POOL_PROFILE_NONE;
+}
+
+/* slot holding address, or the first slot address could go in when reusing */
+static size_t pool_profile_find(pool_profile_t *profile, uintptr_t address, bool reuse) {
+    size_t    index = (address >> 4) * 0x9e3779b97f4a7c15ull % profile->sample_capacity;
+    uintptr_t slot;
+
+    for (size_t probe = 0; probe < profile->sample_capacity; probe++) {
+        slot = __atomic_load_n(&profile->samples[index].address, __ATOMIC_ACQUIRE);
+        if (reuse ? slot <= POOL_PROFILE_REMOVED : slot == address) {
+            return index;
+        }
+        if (slot == 0) {
+            break;
+        }
+        index = (index + 1 < profile->sample_capacity) ? index + 1 : 0;
+    }
+
+    return POOL_PROFILE_NONE;
+}
+
+/* empty the slot, clearing a run of removed slots back to zero when nothing lies past it */
+static void pool_profile_remove(pool_profile_t *profile, size_t index) {
+    size_t next = (index + 1 < profile->sample_capacity) ? index + 1 : 0;
+
+    if (profile->samples[next].address != 0) {
+        __atomic_store_n(&profile->samples[index].address, POOL_PROFILE_REMOVED, __ATOMIC_RELEASE);
+        return;
+    }
+
+    /* misses stop probing at zero, so this keeps probe runs from silting up with removed slots */
+    do {
+        __atomic_store_n(&profile->samples[index].address, 0, __ATOMIC_RELEASE);
+        index = (index > 0) ? index - 1 : profile->sample_capacity - 1;
+    } while (profile->samples[index].address == POOL_PROFILE_REMOVED);
+}
+
+/* site after index in order of live bytes, most first and ties in table order */
+static size_t pool_profile_next(pool_profile_t *profile, uint64_t bytes, size_t index) {
+    size_t   next = POOL_PROFILE_NONE;
+    uint64_t live;
+    bool     after;
+
+    for (size_t i = 0; i < profile->site_capacity; i++) {
+        if (profile->sites[i].hash == 0) {
+            continue;
+        }
+        live  = profile->sites[i].live_bytes;
+        after = live < bytes || (live == bytes && (index == POOL_PROFILE_NONE || i > index));
+        if (after && (next == POOL_PROFILE_NONE || live > profile->sites[next].live_bytes)) {
+            next = i;
+        }
+    }
+
+    return next;
+}
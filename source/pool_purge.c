@@ -0,0 +1,83 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* madvise */
+#endif
+
+#include "pool_purge.h"
+#include "pool_sync.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define POOL_PURGE_SUPPORTED 1
+#endif
+
+void pool_purge_init(pool_purge_t *purge, int advice, size_t threshold, uint64_t interval) {
+    if (purge != NULL) {
+#ifdef POOL_PURGE_SUPPORTED
+        purge->page = (size_t) sysconf(_SC_PAGESIZE);
+#else
+        purge->page = 0;
+#endif
+        purge->threshold = threshold;
+        purge->interval  = interval;
+        purge->last      = 0;
+        purge->watermark = (size_t) -1;
+        purge->purged    = 0;
+        purge->advice    = advice;
+    }
+}
+
+int pool_purge_ready(pool_purge_t *purge) {
+    return (purge != NULL) && (purge->page > 0)
+           && (purge->last == 0 || pool_clock() - purge->last >= purge->interval);
+}
+
+int pool_purge_worth(pool_purge_t *purge, size_t capacity) {
+    if (purge == NULL) {
+        return 0;
+    }
+    if (capacity < purge->watermark) {
+        purge->watermark = capacity;
+    }
+    /* nothing to compare against before the first purge */
+    return purge->last == 0 || capacity - purge->watermark >= purge->threshold;
+}
+
+size_t pool_purge_range(pool_purge_t *purge, void *start, void *end) {
+    size_t    size = 0;
+    uintptr_t first;
+    uintptr_t last;
+
+    if (purge != NULL && purge->page > 0 && start < end) {
+        first = ((uintptr_t) start + purge->page - 1) & ~(uintptr_t) (purge->page - 1);
+        last  = (uintptr_t) end & ~(uintptr_t) (purge->page - 1);
+
+        if (first < last) {
+#ifdef POOL_PURGE_SUPPORTED
+            int advice = MADV_DONTNEED;
+#ifdef MADV_FREE
+            if (purge->advice == POOL_PURGE_FREE) {
+                advice = MADV_FREE;
+            }
+#endif
+            if (madvise((void *) first, last - first, advice) == 0
+                || (advice != MADV_DONTNEED && madvise((void *) first, last - first, MADV_DONTNEED) == 0)) {
+                size = last - first;
+            }
+#endif
+        }
+    }
+
+    return size;
+}
+
+void pool_purge_done(pool_purge_t *purge, size_t capacity) {
+    if (purge != NULL) {
+        purge->last      = pool_clock();
+        purge->watermark = capacity;
+    }
+}
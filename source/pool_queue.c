@@ -0,0 +1,110 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_queue.h"
+#include "pool_node.h"
+#include <stdbool.h>
+
+void pool_queue_init(pool_queue_t *queue, block_pool_t *pool) {
+    pool_node_t *dummy;
+
+    if (queue != NULL && block_pool_is_valid(pool) && pool->alignment >= POOL_NODE_SIZE) {
+        block_pool_mark_shared(pool); /* producers and consumers allocate and release nodes concurrently */
+        if ((dummy = block_allocate(pool)) != NULL) {
+            dummy->next = pool_node_link(0, dummy->next);
+            queue->pool = pool;
+            queue->free = 0;
+            queue->head = pool_node_link(pool_node_number_of(pool, dummy), 0);
+            queue->tail = queue->head;
+        }
+    }
+}
+
+int pool_queue_push(pool_queue_t *queue, void *value) {
+    pool_node_t *node;
+    uint32_t    number;
+    uint64_t    tail;
+    uint64_t    next;
+
+    if (queue == NULL || queue->pool == NULL || (node = pool_node_allocate(queue->pool, &queue->free)) == NULL) {
+        return false;
+    }
+
+    node->value = value;
+    number      = pool_node_number_of(queue->pool, node);
+
+    for (;;) {
+        tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        next = __atomic_load_n(&pool_node_at(queue->pool, pool_node_number(tail))->next, __ATOMIC_ACQUIRE);
+
+        if (tail != __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        if (pool_node_number(next) == 0) {
+            /* link after the last node */
+            if (__atomic_compare_exchange_n(&pool_node_at(queue->pool, pool_node_number(tail))->next, &next,
+                                            pool_node_link(number, next), false,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else {
+            /* tail is lagging, help it along */
+            __atomic_compare_exchange_n(&queue->tail, &tail, pool_node_link(pool_node_number(next), tail), false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_compare_exchange_n(&queue->tail, &tail, pool_node_link(number, tail), false,
+                                __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    return true;
+}
+
+int pool_queue_pop(pool_queue_t *queue, void **value) {
+    uint64_t head;
+    uint64_t tail;
+    uint64_t next;
+    void     *popped = NULL;
+
+    if (queue == NULL || queue->pool == NULL) {
+        return false;
+    }
+
+    for (;;) {
+        head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        next = __atomic_load_n(&pool_node_at(queue->pool, pool_node_number(head))->next, __ATOMIC_ACQUIRE);
+
+        if (head != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        if (pool_node_number(head) == pool_node_number(tail)) {
+            if (pool_node_number(next) == 0) {
+                return false;
+            }
+            __atomic_compare_exchange_n(&queue->tail, &tail, pool_node_link(pool_node_number(next), tail), false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        } else {
+            /* read before the swing, once it lands another thread may recycle the node */
+            popped = pool_node_at(queue->pool, pool_node_number(next))->value;
+            if (__atomic_compare_exchange_n(&queue->head, &head, pool_node_link(pool_node_number(next), head), false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+    }
+
+    if (value != NULL) {
+        *value = popped;
+    }
+
+    /* the old dummy is ours, next becomes the dummy */
+    pool_node_push(queue->pool, &queue->free, pool_node_at(queue->pool, pool_node_number(head)));
+    return true;
+}
+
+size_t pool_queue_trim(pool_queue_t *queue) {
+    return (queue != NULL && queue->pool != NULL) ? pool_node_trim(queue->pool, &queue->free) : 0;
+}
@@ -0,0 +1,59 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_shrink.h"
+
+void pool_shrink_init(pool_shrink_t *shrink) {
+    if (shrink != NULL) {
+        shrink->shrinkers = NULL;
+        shrink->watermark = 0;
+        shrink->running   = 0;
+    }
+}
+
+void pool_shrinker_add(pool_shrink_t *shrink, pool_shrinker_t *shrinker, pool_shrink_callback_t callback, void *context) {
+    if (shrink != NULL && shrinker != NULL && callback != NULL) {
+        shrinker->callback = callback;
+        shrinker->context  = context;
+        shrinker->next     = shrink->shrinkers;
+        shrink->shrinkers  = shrinker;
+    }
+}
+
+void pool_shrinker_remove(pool_shrink_t *shrink, pool_shrinker_t *shrinker) {
+    pool_shrinker_t **link;
+
+    if (shrink != NULL && shrinker != NULL) {
+        for (link = &shrink->shrinkers; *link != NULL; link = &(*link)->next) {
+            if (*link == shrinker) {
+                *link          = shrinker->next;
+                shrinker->next = NULL;
+                break;
+            }
+        }
+    }
+}
+
+void pool_shrink_watermark(pool_shrink_t *shrink, size_t watermark) {
+    if (shrink != NULL) {
+        shrink->watermark = watermark;
+    }
+}
+
+size_t pool_shrink(pool_shrink_t *shrink, size_t target) {
+    pool_shrinker_t *shrinker;
+    size_t          released = 0;
+
+    /* a shrinker allocating from its pool, or a second thread failing meanwhile, doesn't start another round */
+    if (shrink == NULL || shrink->shrinkers == NULL || __atomic_exchange_n(&shrink->running, 1, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    for (shrinker = shrink->shrinkers; shrinker != NULL && released < target; shrinker = shrinker->next) {
+        released += shrinker->callback(shrinker->context, target - released);
+    }
+
+    __atomic_store_n(&shrink->running, 0, __ATOMIC_RELEASE);
+    return released;
+}
@@ -0,0 +1,46 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_stack.h"
+#include "pool_node.h"
+#include <stdbool.h>
+
+void pool_stack_init(pool_stack_t *stack, block_pool_t *pool) {
+    if (stack != NULL && block_pool_is_valid(pool) && pool->alignment >= POOL_NODE_SIZE) {
+        stack->pool = pool;
+        stack->top  = 0;
+        stack->free = 0;
+        block_pool_mark_shared(pool); /* pushers and poppers allocate and release nodes concurrently */
+    }
+}
+
+int pool_stack_push(pool_stack_t *stack, void *value) {
+    pool_node_t *node;
+
+    if (stack == NULL || stack->pool == NULL || (node = pool_node_allocate(stack->pool, &stack->free)) == NULL) {
+        return false;
+    }
+
+    node->value = value;
+    pool_node_push(stack->pool, &stack->top, node);
+    return true;
+}
+
+int pool_stack_pop(pool_stack_t *stack, void **value) {
+    pool_node_t *node;
+
+    if (stack == NULL || stack->pool == NULL || (node = pool_node_pop(stack->pool, &stack->top)) == NULL) {
+        return false;
+    }
+
+    if (value != NULL) {
+        *value = node->value;
+    }
+    pool_node_push(stack->pool, &stack->free, node);
+    return true;
+}
+
+size_t pool_stack_trim(pool_stack_t *stack) {
+    return (stack != NULL && stack->pool != NULL) ? pool_node_trim(stack->pool, &stack->free) : 0;
+}
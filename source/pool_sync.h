@@ -0,0 +1,109 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_SYNC_H
+#define MEMORY_POOL_SYNC_H
+
+/* private synchronization helpers shared by the thread-safe pool front ends */
+
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#include <time.h>
+#define POOL_SYNC_YIELD() sched_yield()
+#else
+#define POOL_SYNC_YIELD() ((void) 0)
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define POOL_SYNC_RELAX() __builtin_ia32_pause()
+#else
+#define POOL_SYNC_RELAX() ((void) 0)
+#endif
+
+#ifndef POOL_SYNC_SPIN
+#define POOL_SYNC_SPIN 64 /* spins before yielding the cpu to the lock holder */
+#endif
+
+static inline void pool_lock(volatile int *lock) {
+    int spin = 0;
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+            if (++spin < POOL_SYNC_SPIN) {
+                POOL_SYNC_RELAX();
+            } else {
+                POOL_SYNC_YIELD();
+                spin = 0;
+            }
+        }
+    }
+}
+
+static inline void pool_unlock(volatile int *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/* lock only pools marked shared, pools used from one thread skip the atomics */
+static inline void pool_lock_shared(volatile int *lock, int shared) {
+    if (shared) {
+        pool_lock(lock);
+    }
+}
+
+static inline void pool_unlock_shared(volatile int *lock, int shared) {
+    if (shared) {
+        pool_unlock(lock);
+    }
+}
+
+/* monotonic nanoseconds, always zero where there is no clock */
+static inline uint64_t pool_clock(void) {
+#if defined(__unix__) || defined(__APPLE__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+/* park while *word == value for at most timeout nanoseconds, may return early. polls without futexes */
+static inline void pool_wait(volatile uint32_t *word, uint32_t value, uint64_t timeout) {
+#if defined(__linux__)
+    struct timespec limit;
+    limit.tv_sec  = (time_t) (timeout / 1000000000u);
+    limit.tv_nsec = (long) (timeout % 1000000000u);
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, &limit, NULL, 0);
+#else
+    (void) word;
+    (void) value;
+    (void) timeout;
+    POOL_SYNC_YIELD();
+#endif
+}
+
+/* wake up to count callers parked on word */
+static inline void pool_wake(volatile uint32_t *word, uint32_t count) {
+#if defined(__linux__)
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void) word;
+    (void) count;
+#endif
+}
+
+/* pool_clock() time timeout nanoseconds from now, saturating */
+static inline uint64_t pool_deadline(uint64_t timeout) {
+    uint64_t now = pool_clock();
+    return (timeout > UINT64_MAX - now) ? UINT64_MAX : now + timeout;
+}
+
+#endif //MEMORY_POOL_SYNC_H
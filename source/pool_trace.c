@@ -0,0 +1,111 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "pool_trace.h"
+#include "pool_sync.h"
+#include <stdio.h>
+#include <string.h>
+
+static pool_trace_t *pool_trace_active = NULL;
+
+void pool_trace_init(pool_trace_t *trace, void *buffer, size_t size) {
+    if (trace != NULL && buffer != NULL && size >= sizeof(pool_trace_event_t)) {
+        trace->events   = buffer;
+        trace->capacity = size / sizeof(pool_trace_event_t);
+        trace->head     = 0;
+    }
+}
+
+void pool_trace_attach(pool_trace_t *trace) {
+    __atomic_store_n(&pool_trace_active, trace, __ATOMIC_RELEASE);
+}
+
+void pool_trace_record(pool_trace_t *trace, uint32_t type, const void *pool, const void *address, size_t size) {
+    pool_trace_event_t *event;
+
+    if (trace != NULL && trace->capacity > 0) {
+        event = &trace->events[__atomic_fetch_add(&trace->head, 1, __ATOMIC_RELAXED) % trace->capacity];
+        event->timestamp = pool_clock();
+        event->pool      = (uintptr_t) pool;
+        event->address   = (uintptr_t) address;
+        event->size      = (uint32_t) size;
+        event->type      = type;
+    }
+}
+
+void pool_trace_emit(uint32_t type, const void *pool, const void *address, size_t size) {
+    pool_trace_t *trace = __atomic_load_n(&pool_trace_active, __ATOMIC_ACQUIRE);
+    if (trace != NULL) {
+        pool_trace_record(trace, type, pool, address, size);
+    }
+}
+
+size_t pool_trace_count(pool_trace_t *trace) {
+    size_t count = 0;
+    if (trace != NULL) {
+        count = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+        if (count > trace->capacity) {
+            count = trace->capacity;
+        }
+    }
+    return count;
+}
+
+size_t pool_trace_read(pool_trace_t *trace, pool_trace_event_t *events, size_t max) {
+    size_t count = pool_trace_count(trace);
+    size_t first;
+
+    if (events == NULL) {
+        return 0;
+    }
+
+    if (count > max) {
+        count = max;
+    }
+
+    if (count > 0) {
+        /* oldest held event sits right after the newest once the ring has wrapped */
+        first = (trace->head - pool_trace_count(trace)) % trace->capacity;
+        for (size_t i = 0; i < count; i++) {
+            events[i] = trace->events[(first + i) % trace->capacity];
+        }
+    }
+
+    return count;
+}
+
+size_t pool_trace_save(pool_trace_t *trace, const char *path) {
+    pool_trace_file_t  header;
+    pool_trace_event_t event;
+    size_t             count = pool_trace_count(trace);
+    size_t             first;
+    size_t             written = 0;
+    FILE               *file;
+
+    if (path == NULL || count == 0 || (file = fopen(path, "wb")) == NULL) {
+        return 0;
+    }
+
+    memcpy(header.magic, POOL_TRACE_MAGIC, sizeof(header.magic));
+    header.version    = POOL_TRACE_VERSION;
+    header.event_size = sizeof(pool_trace_event_t);
+    header.count      = count;
+
+    if (fwrite(&header, sizeof(header), 1, file) == 1) {
+        first = (trace->head - count) % trace->capacity;
+        while (written < count) {
+            event = trace->events[(first + written) % trace->capacity];
+            if (fwrite(&event, sizeof(event), 1, file) != 1) {
+                break;
+            }
+            written++;
+        }
+    }
+
+    if (fclose(file) != 0 || written != count) {
+        written = 0;
+    }
+
+    return written;
+}
@@ -0,0 +1,64 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#ifndef MEMORY_POOL_ZERO_H
+#define MEMORY_POOL_ZERO_H
+
+/* private helpers clearing memory for the zeroed allocation calls */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef POOL_ZERO_STREAM
+#define POOL_ZERO_STREAM (256 * 1024) /* bytes from which clearing bypasses the cache */
+#endif
+
+/*
+ * Clear memory. Large ranges are written with 16 byte non-temporal
+ * stores so clearing them doesn't evict the working set, smaller ones
+ * are left to memset and stay cached for the caller about to use them.
+ */
+static inline void pool_zero(void *memory, size_t size) {
+#if defined(__SSE2__)
+    char    *bytes = memory;
+    size_t  head;
+    __m128i zero;
+
+    if (size >= POOL_ZERO_STREAM) {
+        head = (16 - ((uintptr_t) bytes & 15)) & 15;
+        memset(bytes, 0, head);
+        bytes += head;
+        size  -= head;
+
+        zero = _mm_setzero_si128();
+        for (; size >= 64; bytes += 64, size -= 64) {
+            _mm_stream_si128((__m128i *) bytes, zero);
+            _mm_stream_si128((__m128i *) (bytes + 16), zero);
+            _mm_stream_si128((__m128i *) (bytes + 32), zero);
+            _mm_stream_si128((__m128i *) (bytes + 48), zero);
+        }
+        _mm_sfence();
+        memory = bytes;
+    }
+#endif
+    memset(memory, 0, size);
+}
+
+/*
+ * Clear allocated memory except what lies in never handed out memory
+ * known to read as zero, from untouched onward
+ */
+static inline void pool_zero_used(void *memory, size_t size, const void *untouched, int zeroed) {
+    if (zeroed && (const char *) memory + size > (const char *) untouched) {
+        size = ((const char *) memory < (const char *) untouched) ? (size_t) ((const char *) untouched - (const char *) memory) : 0;
+    }
+    pool_zero(memory, size);
+}
+
+#endif //MEMORY_POOL_ZERO_H
@@ -0,0 +1,231 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "region_pool.h"
+#include <stdint.h>
+
+#define REGION_ROUND(value, alignment) (((value) + (alignment) - 1) & ~(uintptr_t) ((alignment) - 1))
+
+/* sources only promise pointer aligned chunks, the first allocation may need to move up */
+#define REGION_SOURCE_SLACK ((REGION_ALIGNMENT > sizeof(void *)) ? REGION_ALIGNMENT - sizeof(void *) : 0)
+
+/* byte pool header size, byte chunks are whole headers so the one split off behind them stays aligned */
+#define REGION_BYTE_HEADER (2 * sizeof(void *))
+
+static char *region_chunk_start(region_chunk_t *chunk);
+
+static void *region_pool_grow(region_pool_t *region, size_t size);
+
+static size_t region_chunk_release(region_pool_t *region, region_chunk_t *chunk);
+
+void region_pool_init(region_pool_t *region, void *memory, size_t size) {
+    region_chunk_t *chunk;
+
+    if (region != NULL) {
+        region->first      = NULL;
+        region->chunk      = NULL;
+        region->top        = NULL;
+        region->end        = NULL;
+        region->source     = REGION_SOURCE_NONE;
+        region->pool       = NULL;
+        region->chunk_size = 0;
+
+        if (memory != NULL && size > sizeof(region_chunk_t) + 2 * REGION_ALIGNMENT) {
+            chunk       = (region_chunk_t *) REGION_ROUND((uintptr_t) memory, REGION_ALIGNMENT);
+            chunk->next = NULL;
+            chunk->end  = (char *) memory + size;
+            chunk->size = 0;
+
+            region->first = chunk;
+            region_reset(region);
+        }
+    }
+}
+
+void region_pool_segment_source(region_pool_t *region, segment_pool_t *pool) {
+    if (region != NULL && pool != NULL && pool->alignment > sizeof(region_chunk_t)) {
+        region->source     = REGION_SOURCE_SEGMENT;
+        region->pool       = pool;
+        region->chunk_size = pool->alignment;
+    }
+}
+
+void region_pool_byte_source(region_pool_t *region, byte_pool_t *pool, size_t chunk_size) {
+    if (region != NULL && byte_pool_is_valid(pool) && chunk_size > sizeof(region_chunk_t)
+        && chunk_size <= SIZE_MAX - REGION_BYTE_HEADER) {
+        region->source     = REGION_SOURCE_BYTE;
+        region->pool       = pool;
+        region->chunk_size = REGION_ROUND(chunk_size, REGION_BYTE_HEADER);
+    }
+}
+
+int region_pool_is_valid(region_pool_t *region) {
+    return (region != NULL)
+           && (region->first != NULL || region->source != REGION_SOURCE_NONE)
+           && (region->top <= region->end);
+}
+
+void *region_allocate(region_pool_t *region, size_t size) {
+    void *return_ptr = NULL;
+
+    if (region != NULL && size > 0 && size <= SIZE_MAX - REGION_ALIGNMENT) {
+        size = REGION_ROUND(size, REGION_ALIGNMENT);
+
+        if (size <= (size_t) (region->end - region->top)) {
+            return_ptr   = region->top;
+            region->top += size;
+        } else {
+            return_ptr = region_pool_grow(region, size);
+        }
+    }
+
+    return return_ptr;
+}
+
+region_mark_t region_mark(region_pool_t *region) {
+    region_mark_t mark = {NULL, NULL};
+
+    if (region != NULL) {
+        mark.chunk = region->chunk;
+        mark.top   = region->top;
+    }
+
+    return mark;
+}
+
+void region_rewind(region_pool_t *region, region_mark_t mark) {
+    if (region != NULL) {
+        if (mark.chunk == NULL) {
+            /* marked before the first chunk was taken */
+            region_reset(region);
+        } else {
+            region->chunk = mark.chunk;
+            region->top   = mark.top;
+            region->end   = mark.chunk->end;
+        }
+    }
+}
+
+void region_reset(region_pool_t *region) {
+    if (region != NULL) {
+        region->chunk = region->first;
+        region->top   = (region->first != NULL) ? region_chunk_start(region->first) : NULL;
+        region->end   = (region->first != NULL) ? region->first->end : NULL;
+    }
+}
+
+size_t region_pool_trim(region_pool_t *region) {
+    size_t released = 0;
+
+    if (region != NULL && region->chunk != NULL) {
+        released            = region_chunk_release(region, region->chunk->next);
+        region->chunk->next = NULL;
+    }
+
+    return released;
+}
+
+size_t region_pool_release(region_pool_t *region) {
+    region_chunk_t *chunk;
+    size_t         released = 0;
+
+    if (region != NULL && region->first != NULL) {
+        /* caller memory can only be the first chunk, keep it */
+        chunk = region->first;
+        if (chunk->size == 0) {
+            chunk               = chunk->next;
+            region->first->next = NULL;
+        } else {
+            region->first = NULL;
+        }
+
+        released = region_chunk_release(region, chunk);
+        region_reset(region);
+    }
+
+    return released;
+}
+
+static char *region_chunk_start(region_chunk_t *chunk) {
+    return (char *) REGION_ROUND((uintptr_t) (chunk + 1), REGION_ALIGNMENT);
+}
+
+/* move to the next chunk if it fits size, otherwise take a new one from the source */
+static void *region_pool_grow(region_pool_t *region, size_t size) {
+    region_chunk_t *chunk = (region->chunk != NULL) ? region->chunk->next : NULL;
+    size_t         bytes  = 0;
+    size_t         need;
+
+    if (chunk == NULL || size > (size_t) (chunk->end - region_chunk_start(chunk))) {
+        if (size > SIZE_MAX - sizeof(region_chunk_t) - 2 * REGION_ALIGNMENT - REGION_BYTE_HEADER) {
+            return NULL;
+        }
+        need  = REGION_ROUND(sizeof(region_chunk_t), REGION_ALIGNMENT) + REGION_SOURCE_SLACK + size;
+        chunk = NULL;
+
+        switch (region->source) {
+            case REGION_SOURCE_SEGMENT:
+                bytes = REGION_ROUND(need, region->chunk_size);
+                chunk = (bytes == region->chunk_size) ? segment_allocate(region->pool)
+                                                      : segment_allocate_size(region->pool, bytes);
+                break;
+            case REGION_SOURCE_BYTE:
+                bytes = (need > region->chunk_size) ? REGION_ROUND(need, REGION_BYTE_HEADER) : region->chunk_size;
+                chunk = byte_allocate(region->pool, bytes);
+                break;
+            default:
+                break;
+        }
+
+        if (chunk == NULL) {
+            return NULL;
+        }
+
+        /* spare chunks left by a rewind stay queued after the new one */
+        chunk->end  = (char *) chunk + bytes;
+        chunk->size = bytes;
+        if (region->chunk != NULL) {
+            chunk->next         = region->chunk->next;
+            region->chunk->next = chunk;
+        } else {
+            chunk->next   = NULL;
+            region->first = chunk;
+        }
+    }
+
+    region->chunk = chunk;
+    region->top   = region_chunk_start(chunk) + size;
+    region->end   = chunk->end;
+    return region_chunk_start(chunk);
+}
+
+/* return a list of chunks to the source, newest first so released neighbours merge forward */
+static size_t region_chunk_release(region_pool_t *region, region_chunk_t *chunk) {
+    region_chunk_t *reversed = NULL;
+    region_chunk_t *next;
+    size_t         released  = 0;
+
+    for (; chunk != NULL; chunk = next) {
+        next        = chunk->next;
+        chunk->next = reversed;
+        reversed    = chunk;
+    }
+
+    for (chunk = reversed; chunk != NULL; chunk = next) {
+        next      = chunk->next;
+        released += chunk->size;
+
+        if (region->source == REGION_SOURCE_SEGMENT) {
+            if (chunk->size == region->chunk_size) {
+                segment_release(region->pool, chunk);
+            } else {
+                segment_release_size(region->pool, chunk, chunk->size);
+            }
+        } else if (region->source == REGION_SOURCE_BYTE) {
+            byte_release(chunk);
+        }
+    }
+
+    return released;
+}
@@ -0,0 +1,148 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include "segment_chain.h"
+#include <stdbool.h>
+
+struct segment_link_t {
+    segment_link_t  *next;
+    volatile size_t references;
+};
+
+static size_t segment_chain_payload(const segment_slice_t *slice);
+
+static void segment_chain_empty(segment_slice_t *slice, segment_pool_t *pool);
+
+int segment_chain_allocate(segment_pool_t *pool, segment_slice_t *slice, size_t size) {
+    segment_link_t *segment;
+    segment_link_t *last = NULL;
+    size_t         payload;
+    size_t         count;
+    size_t         taken;
+
+    if (slice == NULL) {
+        return false;
+    }
+    segment_chain_empty(slice, pool);
+
+    if (segment_pool_empty(pool) || pool->alignment <= SEGMENT_CHAIN_HEADER || size == 0) {
+        return false;
+    }
+
+    payload = segment_chain_payload(slice);
+    count   = size / payload + (size % payload != 0); /* rounding up by adding would wrap */
+    for (taken = 0; taken < count; taken++) {
+        segment = segment_allocate(pool);
+        if (segment == NULL) {
+            /* give back what was taken so far */
+            slice->length = taken * payload;
+            segment_chain_release(slice);
+            return false;
+        }
+
+        segment->next       = NULL;
+        segment->references = 1;
+        if (last != NULL) {
+            last->next = segment;
+        } else {
+            slice->first = segment;
+        }
+        last = segment;
+    }
+
+    slice->length = size;
+    return true;
+}
+
+int segment_chain_iovec(const segment_slice_t *slice, struct iovec *iov, int count) {
+    segment_link_t *segment;
+    size_t         offset;
+    size_t         length;
+    int            filled = 0;
+
+    if (slice != NULL && iov != NULL) {
+        segment = slice->first;
+        offset  = slice->offset;
+        length  = slice->length;
+
+        while (segment != NULL && length > 0 && filled < count) {
+            iov[filled].iov_base = (char *) segment + SEGMENT_CHAIN_HEADER + offset;
+            iov[filled].iov_len  = segment_chain_payload(slice) - offset;
+            if (iov[filled].iov_len > length) {
+                iov[filled].iov_len = length;
+            }
+
+            length -= iov[filled].iov_len;
+            offset  = 0;
+            segment = segment->next;
+            filled++;
+        }
+    }
+
+    return filled;
+}
+
+void segment_chain_share(segment_slice_t *slice, const segment_slice_t *source, size_t offset, size_t length) {
+    segment_link_t *segment;
+    size_t         remaining;
+
+    if (slice == NULL || source == NULL) {
+        return;
+    }
+    segment_chain_empty(slice, source->pool);
+
+    if (offset < source->length && length > 0) {
+        if (length > source->length - offset) {
+            length = source->length - offset;
+        }
+
+        /* find the segment holding offset */
+        segment = source->first;
+        offset += source->offset;
+        while (offset >= segment_chain_payload(source)) {
+            offset -= segment_chain_payload(source);
+            segment = segment->next;
+        }
+
+        slice->first  = segment;
+        slice->offset = offset;
+        slice->length = length;
+
+        for (remaining = offset + length; remaining > 0; segment = segment->next) {
+            __atomic_add_fetch(&segment->references, 1, __ATOMIC_RELAXED);
+            remaining -= (remaining < segment_chain_payload(slice)) ? remaining : segment_chain_payload(slice);
+        }
+    }
+}
+
+void segment_chain_release(segment_slice_t *slice) {
+    segment_link_t *segment;
+    segment_link_t *next;
+    size_t         remaining;
+
+    if (slice != NULL && slice->first != NULL) {
+        segment = slice->first;
+        for (remaining = slice->offset + slice->length; remaining > 0; segment = next) {
+            /* read the link first, the segment is reusable once released */
+            next       = segment->next;
+            remaining -= (remaining < segment_chain_payload(slice)) ? remaining : segment_chain_payload(slice);
+            if (__atomic_sub_fetch(&segment->references, 1, __ATOMIC_ACQ_REL) == 0) {
+                segment_release(slice->pool, segment);
+            }
+        }
+
+        segment_chain_empty(slice, slice->pool);
+    }
+}
+
+static size_t segment_chain_payload(const segment_slice_t *slice) {
+    return slice->pool->alignment - SEGMENT_CHAIN_HEADER;
+}
+
+static void segment_chain_empty(segment_slice_t *slice, segment_pool_t *pool) {
+    slice->pool   = pool;
+    slice->first  = NULL;
+    slice->offset = 0;
+    slice->length = 0;
+}
@@ -3,17 +3,51 @@
 //
 
 #include "segment_pool.h"
+#include "pool_probe.h"
+#include "pool_sync.h"
+#include "pool_zero.h"
 #include <stdbool.h>
 
+/* link tag of a free run whose pages were purged, the word after the link holds the run's end */
+#define SEGMENT_PURGED ((uintptr_t) 1)
+
 static void segment_pool_segment(void *memory, size_t alignment, size_t size, bool null_ending);
 
+static uint32_t segment_pool_signal(segment_pool_t *pool, size_t count);
+
+static void segment_pool_touch(segment_pool_t *pool, void *memory, size_t size);
+
+static void *segment_pool_next(segment_pool_t *pool, void *segment);
+
+static char *segment_pool_link(void *segment);
+
+static void segment_pool_set_link(void *segment, void *next);
+
+static char *segment_pool_run_end(segment_pool_t *pool, void *segment);
+
+static void *segment_pool_sort(void *list);
+
 void segment_pool_init(segment_pool_t *pool, size_t alignment, void *start, void *end) {
     pool->alignment = (alignment < sizeof(void*)) ? sizeof(void*) : alignment;
     pool->start = start;
     pool->search = start;
     pool->end = end;
+    pool->lock = 0;
+    pool->waiters = 0;
+    pool->wake = 0;
+    pool->untouched = start;
+    pool->zeroed = 0;
+    pool->shared = 0;
+
+    if(start == NULL || end < start || (size_t)(end - start) < pool->alignment) {
+        /* not even one whole segment, leave the pool empty */
+        pool->search = NULL;
+        return;
+    }
 
-    segment_pool_segment(pool->start, pool->alignment, pool->end-pool->start, true);
+    /* link every whole segment, the last one terminates the list */
+    segment_pool_segment(pool->start, pool->alignment,
+                         ((pool->end - pool->start) / pool->alignment - 1) * pool->alignment, true);
     pool->search = pool->start;
 }
 
@@ -22,42 +56,137 @@ int segment_pool_empty(segment_pool_t *pool) {
 }
 
 void *segment_allocate(struct segment_pool_t *pool) {
-    void *return_ptr = pool->search;
+    void *return_ptr;
+    pool_lock_shared(&pool->lock, pool->shared);
+    return_ptr = pool->search;
     if(pool->search) {
-        pool->search = *(void **)pool->search;
+        pool->search = segment_pool_next(pool, pool->search);
+        segment_pool_touch(pool, return_ptr, pool->alignment);
+    }
+    pool_unlock_shared(&pool->lock, pool->shared);
+    POOL_PROBE3(segment_allocate, pool, return_ptr, pool->alignment);
+    return return_ptr;
+}
+
+void *segment_allocate_zeroed(struct segment_pool_t *pool) {
+    void *return_ptr;
+    void *untouched;
+    bool purged = false;
+    pool_lock_shared(&pool->lock, pool->shared);
+    untouched = pool->untouched;
+    return_ptr = pool->search;
+    if(pool->search) {
+        purged = (*(uintptr_t *)pool->search & SEGMENT_PURGED) != 0;
+        pool->search = segment_pool_next(pool, pool->search);
+        segment_pool_touch(pool, return_ptr, pool->alignment);
+    }
+    pool_unlock_shared(&pool->lock, pool->shared);
+    POOL_PROBE3(segment_allocate, pool, return_ptr, pool->alignment);
+    if(return_ptr != NULL) {
+        /* untouched segments still hold the link written at init */
+        pool_zero_used(return_ptr, pool->alignment, untouched, pool->zeroed);
+        *(void **)return_ptr = NULL;
+        if(purged && pool->alignment >= 2 * sizeof(void *)) {
+            ((void **)return_ptr)[1] = NULL; /* end of the purged run it started */
+        }
+    }
+    return return_ptr;
+}
+
+void segment_pool_mark_zeroed(struct segment_pool_t *pool) {
+    if(pool != NULL && pool->start != NULL) {
+        pool->zeroed = 1;
+    }
+}
+
+void segment_pool_mark_shared(struct segment_pool_t *pool) {
+    if(pool != NULL && pool->start != NULL) {
+        pool->shared = 1;
+    }
+}
+
+void *segment_allocate_wait(struct segment_pool_t *pool, uint64_t timeout) {
+    void *return_ptr = NULL;
+    uint64_t deadline;
+    uint64_t now;
+    uint32_t wake;
+
+    if(pool != NULL && pool->start != NULL) {
+        /* nothing can release into a pool used from one thread, so only try once */
+        deadline = pool->shared ? pool_deadline(timeout) : 0;
+
+        pool_lock_shared(&pool->lock, pool->shared);
+        while((return_ptr = pool->search) == NULL && (now = pool_clock()) < deadline) {
+            /* sample the futex word under the lock so a release after unlocking isn't missed */
+            pool->waiters++;
+            wake = pool->wake;
+            pool_unlock_shared(&pool->lock, pool->shared);
+
+            pool_wait(&pool->wake, wake, deadline - now);
+
+            pool_lock_shared(&pool->lock, pool->shared);
+            pool->waiters--;
+        }
+        if(return_ptr != NULL) {
+            pool->search = segment_pool_next(pool, return_ptr);
+            segment_pool_touch(pool, return_ptr, pool->alignment);
+        }
+        pool_unlock_shared(&pool->lock, pool->shared);
+        POOL_PROBE3(segment_allocate, pool, return_ptr, pool->alignment);
     }
     return return_ptr;
 }
 
 void segment_release(struct segment_pool_t *pool, void *memory) {
+    uint32_t wake;
+    POOL_PROBE3(segment_release, pool, memory, pool->alignment);
+    pool_lock_shared(&pool->lock, pool->shared);
     *(char **)memory = pool->search;
     pool->search = memory;
+    wake = segment_pool_signal(pool, 1);
+    pool_unlock_shared(&pool->lock, pool->shared);
+    if(wake > 0) {
+        pool_wake(&pool->wake, wake);
+    }
 }
 
 void segment_ordered_release(struct segment_pool_t *pool, void *memory) {
-    void *search = pool->search;
+    void *search;
     void *next;
+    uint32_t wake = 0;
 
+    POOL_PROBE3(segment_release, pool, memory, pool->alignment);
+    pool_lock_shared(&pool->lock, pool->shared);
+    search = pool->search;
     while(search != NULL) {
-        next = *(char**)search;
+        next = segment_pool_link(search);
         if(search < memory && memory < next) {
             *(char**)memory = next;
-            *(char**)search = memory;
+            segment_pool_set_link(search, memory);
+            wake = segment_pool_signal(pool, 1);
             search = NULL; /*done searching */
         } else {
             search = next;
         }
     }
+    pool_unlock_shared(&pool->lock, pool->shared);
+    if(wake > 0) {
+        pool_wake(&pool->wake, wake);
+    }
 }
 
 void *segment_allocate_size(struct segment_pool_t *pool, size_t size) {
-    void *search = pool->search;
+    void *search;
     void *next;
     void *return_ptr= NULL;
     size_t available = 0;
+    size_t walk = 0;
 
+    pool_lock_shared(&pool->lock, pool->shared);
+    search = pool->search;
     while(search != NULL && available < size) {
-        next = *(char**)search;
+        walk++;
+        next = segment_pool_next(pool, search);
         if(next == search+pool->alignment) {
             /* this is free */
             available += pool->alignment;
@@ -70,32 +199,96 @@ void *segment_allocate_size(struct segment_pool_t *pool, size_t size) {
     if(available >= size) {
         pool->search = search;
         return_ptr = search-available;
+        segment_pool_touch(pool, return_ptr, available);
     }
+    pool_unlock_shared(&pool->lock, pool->shared);
+    POOL_PROBE4(segment_allocate_size, pool, return_ptr, size, walk);
 
     return return_ptr;
 }
 
 void segment_release_size(struct segment_pool_t *pool, void *memory, size_t size) {
+    uint32_t wake;
+    POOL_PROBE3(segment_release, pool, memory, size);
+    pool_lock_shared(&pool->lock, pool->shared);
     segment_pool_segment(memory, pool->alignment, size - pool->alignment, true);
     *(char**)(memory+size-pool->alignment) = pool->search;
     pool->search = memory;
+    wake = segment_pool_signal(pool, size / pool->alignment);
+    pool_unlock_shared(&pool->lock, pool->shared);
+    if(wake > 0) {
+        pool_wake(&pool->wake, wake);
+    }
 }
 
 void segment_ordered_release_size(struct segment_pool_t *pool, void *memory, size_t size) {
-    void *search = pool->search;
+    void *search;
     void *next;
+    uint32_t wake = 0;
 
+    POOL_PROBE3(segment_release, pool, memory, size);
+    pool_lock_shared(&pool->lock, pool->shared);
+    search = pool->search;
     while(search != NULL) {
-        next = *(char**)search;
+        next = segment_pool_link(search);
         if(search < memory && memory < next) {
             segment_pool_segment(memory, pool->alignment, size - pool->alignment, true);
             *(char**)(memory+size-pool->alignment) = pool->search;
             pool->search = memory;
+            wake = segment_pool_signal(pool, size / pool->alignment);
             search = NULL; /*done searching */
         } else {
             search = next;
         }
     }
+    pool_unlock_shared(&pool->lock, pool->shared);
+    if(wake > 0) {
+        pool_wake(&pool->wake, wake);
+    }
+}
+
+size_t segment_pool_purge(segment_pool_t *pool, pool_purge_t *purge) {
+    char *first;
+    char *end;
+    char *next;
+    size_t count;
+    size_t links;
+    size_t range;
+    size_t purged = 0;
+
+    if (!segment_pool_empty(pool) && pool_purge_ready(purge)) {
+        pool_lock_shared(&pool->lock, pool->shared);
+        pool->search = segment_pool_sort(pool->search);
+
+        for (first = pool->search; first != NULL; first = next) {
+            /* gather the run of free segments following first in address order */
+            end  = segment_pool_run_end(pool, first);
+            next = segment_pool_link(first);
+            for (count = 1; next == end; count++) {
+                end  = segment_pool_run_end(pool, next);
+                next = segment_pool_link(next);
+            }
+
+            if (count == 1 && (*(uintptr_t *)first & SEGMENT_PURGED)) {
+                continue; /* purged before and unchanged since */
+            }
+
+            /* a run keeps its link and end resident, a lone segment just its link */
+            links = (end > first + pool->alignment) ? 2 : 1;
+            range = pool_purge_range(purge, first + links * sizeof(void *), end);
+            if (range > 0 && links == 2) {
+                *(uintptr_t *)first = (uintptr_t)next | SEGMENT_PURGED;
+                ((char **)first)[1] = end;
+            }
+            purged += range;
+        }
+        pool_unlock_shared(&pool->lock, pool->shared);
+
+        purge->purged += purged;
+        pool_purge_done(purge, 0);
+    }
+
+    return purged;
 }
 
 static void segment_pool_segment(void *memory, size_t alignment, size_t size, bool null_ending) {
@@ -106,4 +299,114 @@ static void segment_pool_segment(void *memory, size_t alignment, size_t size, bo
     if(null_ending) {
         *(char **) memory = NULL; /* null terminated end */
     }
-}
\ No newline at end of file
+}
+/* bump the futex word for count returned segments, returns the number of waiters to wake */
+static uint32_t segment_pool_signal(segment_pool_t *pool, size_t count) {
+    uint32_t wake = 0;
+    if(pool->waiters > 0) {
+        pool->wake++;
+        wake = (count < pool->waiters) ? (uint32_t) count : pool->waiters;
+    }
+    return wake;
+}
+
+/* raise the mark of memory handed out, called under the pool lock */
+static void segment_pool_touch(segment_pool_t *pool, void *memory, size_t size) {
+    if(memory + size > pool->untouched) {
+        pool->untouched = memory + size;
+    }
+}
+
+/* follow a free segment's link, rebuilding one link of a purged run at a time */
+static void *segment_pool_next(segment_pool_t *pool, void *segment) {
+    uintptr_t link = *(uintptr_t *)segment;
+    char *end;
+    char *following;
+
+    if(!(link & SEGMENT_PURGED)) {
+        return (void *)link;
+    }
+
+    /* read the end first, with pointer sized segments it sits in the following one */
+    end = ((char **)segment)[1];
+    following = (char *)segment + pool->alignment;
+    if(following + pool->alignment == end) {
+        *(uintptr_t *)following = link & ~SEGMENT_PURGED;
+    } else {
+        *(uintptr_t *)following = link;
+        ((char **)following)[1] = end;
+    }
+    *(char **)segment = following;
+    return following;
+}
+
+/* next list entry, stepping over a purged run without touching it */
+static char *segment_pool_link(void *segment) {
+    return (char *)(*(uintptr_t *)segment & ~SEGMENT_PURGED);
+}
+
+static void segment_pool_set_link(void *segment, void *next) {
+    *(uintptr_t *)segment = (uintptr_t)next | (*(uintptr_t *)segment & SEGMENT_PURGED);
+}
+
+/* one past the last segment covered by a list entry */
+static char *segment_pool_run_end(segment_pool_t *pool, void *segment) {
+    if(*(uintptr_t *)segment & SEGMENT_PURGED) {
+        return ((char **)segment)[1];
+    }
+    return (char *)segment + pool->alignment;
+}
+
+/* bottom up merge sort of the free list by address, a purged run moves as one entry */
+static void *segment_pool_sort(void *list) {
+    char *left;
+    char *right;
+    char *entry;
+    char *tail;
+    size_t width;
+    size_t merges;
+    size_t left_size;
+    size_t right_size;
+
+    for(width = 1; list != NULL; width *= 2) {
+        left = list;
+        list = NULL;
+        tail = NULL;
+        merges = 0;
+
+        while(left != NULL) {
+            merges++;
+            right = left;
+            for(left_size = 0; left_size < width && right != NULL; left_size++) {
+                right = segment_pool_link(right);
+            }
+
+            for(right_size = width; left_size > 0 || (right_size > 0 && right != NULL);) {
+                if(left_size == 0 || (right_size > 0 && right != NULL && right < left)) {
+                    entry = right;
+                    right = segment_pool_link(right);
+                    right_size--;
+                } else {
+                    entry = left;
+                    left = segment_pool_link(left);
+                    left_size--;
+                }
+
+                if(tail != NULL) {
+                    segment_pool_set_link(tail, entry);
+                } else {
+                    list = entry;
+                }
+                tail = entry;
+            }
+            left = right;
+        }
+
+        segment_pool_set_link(tail, NULL);
+        if(merges <= 1) {
+            break;
+        }
+    }
+
+    return list;
+}
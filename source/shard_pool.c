@@ -0,0 +1,157 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_getcpu */
+#endif
+
+#include "shard_pool.h"
+#include "pool_sync.h"
+#include <stdbool.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+static size_t shard_pool_refill(shard_pool_t *pool, shard_t *shard);
+
+static size_t shard_pool_spill(shard_pool_t *pool, shard_t *shard, size_t count);
+
+void shard_pool_init(shard_pool_t *pool, shard_t *shards, size_t shard_count, size_t alignment, void *start, void *end) {
+    if (pool != NULL && shards != NULL && shard_count > 0 && start != NULL && end != NULL && start < end) {
+        segment_pool_init(&pool->global, alignment, start, end);
+        pool->shards      = shards;
+        pool->shard_count = shard_count;
+        pool->batch       = SHARD_POOL_BATCH;
+        pool->lock        = 0;
+
+        for (size_t i = 0; i < shard_count; i++) {
+            shards[i].cache.start     = pool->global.start;
+            shards[i].cache.search    = NULL;
+            shards[i].cache.end       = pool->global.end;
+            shards[i].cache.alignment = pool->global.alignment;
+            shards[i].cache.lock      = 0;
+            shards[i].cache.waiters   = 0;
+            shards[i].cache.wake      = 0;
+            shards[i].cache.untouched = pool->global.end;
+            shards[i].cache.zeroed    = 0;
+            shards[i].count           = 0;
+            shards[i].active          = false;
+            shards[i].lock            = 0;
+        }
+    }
+}
+
+void *shard_allocate(shard_pool_t *pool) {
+    void    *return_ptr = NULL;
+    shard_t *shard;
+
+    if (pool != NULL && pool->shards != NULL) {
+        shard = &pool->shards[shard_pool_current(pool)];
+
+        pool_lock(&shard->lock);
+        shard->active = true;
+        if (shard->count > 0 || shard_pool_refill(pool, shard) > 0) {
+            return_ptr = segment_allocate(&shard->cache);
+            shard->count--;
+        }
+        pool_unlock(&shard->lock);
+    }
+
+    return return_ptr;
+}
+
+void shard_release(shard_pool_t *pool, void *memory) {
+    shard_t *shard;
+
+    if (pool != NULL && pool->shards != NULL && memory != NULL) {
+        shard = &pool->shards[shard_pool_current(pool)];
+
+        pool_lock(&shard->lock);
+        shard->active = true;
+        segment_release(&shard->cache, memory);
+        shard->count++;
+        if (shard->count >= 2 * pool->batch) {
+            /* keep a batch for the next allocations and give the rest back */
+            shard_pool_spill(pool, shard, shard->count - pool->batch);
+        }
+        pool_unlock(&shard->lock);
+    }
+}
+
+size_t shard_pool_current(shard_pool_t *pool) {
+    int cpu = 0;
+
+#if defined(__linux__)
+    cpu = sched_getcpu();
+    if (cpu < 0) {
+        cpu = 0;
+    }
+#endif
+
+    return (size_t) cpu % pool->shard_count;
+}
+
+size_t shard_pool_drain(shard_pool_t *pool, size_t shard) {
+    size_t count = 0;
+
+    if (pool != NULL && pool->shards != NULL && shard < pool->shard_count) {
+        pool_lock(&pool->shards[shard].lock);
+        count = shard_pool_spill(pool, &pool->shards[shard], pool->shards[shard].count);
+        pool_unlock(&pool->shards[shard].lock);
+    }
+
+    return count;
+}
+
+size_t shard_pool_trim(shard_pool_t *pool) {
+    size_t  count = 0;
+    shard_t *shard;
+
+    if (pool != NULL && pool->shards != NULL) {
+        for (size_t i = 0; i < pool->shard_count; i++) {
+            shard = &pool->shards[i];
+            pool_lock(&shard->lock);
+            if (!shard->active) {
+                count += shard_pool_spill(pool, shard, shard->count);
+            }
+            shard->active = false;
+            pool_unlock(&shard->lock);
+        }
+    }
+
+    return count;
+}
+
+/* move up to one batch from the global pool into the shard, shard lock must be held */
+static size_t shard_pool_refill(shard_pool_t *pool, shard_t *shard) {
+    size_t count = 0;
+    void   *segment;
+
+    pool_lock(&pool->lock);
+    while (count < pool->batch && (segment = segment_allocate(&pool->global)) != NULL) {
+        segment_release(&shard->cache, segment);
+        count++;
+    }
+    pool_unlock(&pool->lock);
+
+    shard->count += count;
+    return count;
+}
+
+/* move count segments from the shard back to the global pool, shard lock must be held */
+static size_t shard_pool_spill(shard_pool_t *pool, shard_t *shard, size_t count) {
+    size_t spilled = 0;
+    void   *segment;
+
+    pool_lock(&pool->lock);
+    while (spilled < count && (segment = segment_allocate(&shard->cache)) != NULL) {
+        segment_release(&pool->global, segment);
+        spilled++;
+    }
+    pool_unlock(&pool->lock);
+
+    shard->count -= spilled;
+    return spilled;
+}
@@ -0,0 +1,126 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "block_class.h"
+
+class BlockClassTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        block_pool_init(&pools[0], 64, small, small + sizeof(small));
+        block_pool_init(&pools[1], 128, medium, medium + sizeof(medium));
+        block_pool_init(&pools[2], 256, large, large + sizeof(large));
+        block_class_init(&classes, pools, 3, 8);
+    }
+
+    void Request(size_t size, int times) {
+        std::vector<void *> blocks;
+        for (int i = 0; i < times; i++) {
+            blocks.push_back(block_class_allocate(&classes, size));
+        }
+        for (void *block : blocks) {
+            block_class_release(&classes, block);
+        }
+    }
+
+    block_class_pool_t classes = {};
+    block_pool_t       pools[3];
+    alignas(8) uint8_t small[1024];
+    alignas(8) uint8_t medium[2048];
+    alignas(8) uint8_t large[4096];
+};
+
+TEST_F(BlockClassTestFixture, init_ignores_bad_inputs) {
+    block_class_pool_t empty = {};
+    block_class_pool_t other = {};
+    block_pool_t       invalid = {};
+
+    block_class_init(NULL, pools, 3, 8);
+    block_class_init(&other, NULL, 3, 8);
+    block_class_init(&other, pools, 0, 8);
+    block_class_init(&other, pools, BLOCK_CLASS_MAX + 1, 8);
+    block_class_init(&other, pools, 3, 12);
+    block_class_init(&other, &invalid, 1, 8);
+    EXPECT_EQ(memcmp(&other, &empty, sizeof(other)), 0);
+    EXPECT_FALSE(block_class_pool_is_valid(&other));
+    EXPECT_TRUE(block_class_pool_is_valid(&classes));
+}
+
+TEST_F(BlockClassTestFixture, allocate_uses_smallest_fitting_class) {
+    void *block = block_class_allocate(&classes, 100);
+
+    EXPECT_GT(block, (void *) medium);
+    EXPECT_LT(block, (void *) (medium + sizeof(medium)));
+    EXPECT_EQ(classes.histogram[(100 - 1) / 8], 1);
+    EXPECT_EQ(block_class_allocate(&classes, 257), nullptr);
+    EXPECT_EQ(block_class_allocate(&classes, 0), nullptr);
+    block_class_release(&classes, block);
+}
+
+TEST_F(BlockClassTestFixture, allocate_falls_back_to_larger_class) {
+    while (block_allocate(&pools[0]) != NULL) {}
+
+    void *block = block_class_allocate(&classes, 24);
+    EXPECT_GT(block, (void *) medium);
+    EXPECT_LT(block, (void *) (medium + sizeof(medium)));
+}
+
+TEST_F(BlockClassTestFixture, tune_fits_classes_to_requested_sizes) {
+    Request(24, 10);
+    Request(40, 40);
+    Request(200, 5);
+    uint64_t before = block_class_waste(&classes, NULL);
+
+    EXPECT_EQ(block_class_tune(&classes), 3);
+    EXPECT_LT(block_class_waste(&classes, NULL), before);
+
+    // busiest class by bytes gets the largest pool
+    EXPECT_EQ(pools[0].alignment, 24);
+    EXPECT_EQ(pools[1].alignment, 200);
+    EXPECT_EQ(pools[2].alignment, 40);
+    EXPECT_EQ(pools[2].capacity, sizeof(large) / (40 + sizeof(void *)));
+    EXPECT_EQ(pools[2].available, pools[2].capacity);
+
+    // the histogram is halved so newer requests carry more weight
+    EXPECT_EQ(classes.histogram[(40 - 1) / 8], 20);
+}
+
+TEST_F(BlockClassTestFixture, tune_merges_sizes_when_classes_run_out) {
+    Request(16, 100);
+    Request(24, 100);
+    Request(64, 1);
+    Request(128, 100);
+
+    block_class_tune(&classes);
+    size_t sizes[3] = {pools[0].alignment, pools[1].alignment, pools[2].alignment};
+    std::sort(sizes, sizes + 3);
+
+    // folding the rare 64 byte requests into 128 wastes least
+    EXPECT_EQ(sizes[0], 16);
+    EXPECT_EQ(sizes[1], 24);
+    EXPECT_EQ(sizes[2], 128);
+}
+
+TEST_F(BlockClassTestFixture, pool_in_use_is_rebuilt_once_released) {
+    Request(24, 4);
+    void *block = block_class_allocate(&classes, 24);
+
+    EXPECT_EQ(block_class_tune(&classes), 2);
+    EXPECT_EQ(pools[0].alignment, 64);
+    EXPECT_EQ(classes.planned[0], 24);
+
+    block_class_release(&classes, block);
+    EXPECT_EQ(pools[0].alignment, 24);
+    EXPECT_EQ(pools[0].available, pools[0].capacity);
+}
+
+TEST_F(BlockClassTestFixture, tune_without_requests_changes_nothing) {
+    EXPECT_EQ(block_class_tune(&classes), 0);
+    EXPECT_EQ(pools[0].alignment, 64);
+    EXPECT_EQ(pools[1].alignment, 128);
+    EXPECT_EQ(pools[2].alignment, 256);
+}
@@ -0,0 +1,117 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "block_epoch.h"
+
+class BlockEpochTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        block_pool_init(&pool, sizeof(node_t), buffer, buffer + sizeof(buffer));
+        block_epoch_init(&domain, &pool);
+        block_epoch_register(&domain, &writer);
+        block_epoch_register(&domain, &reader);
+    }
+
+    struct node_t {
+        uint64_t first;
+        uint64_t second;
+    };
+
+    block_pool_t         pool = {};
+    block_epoch_t        domain = {};
+    block_epoch_record_t writer = {};
+    block_epoch_record_t reader = {};
+    alignas(16) uint8_t  buffer[256 * (sizeof(node_t) + sizeof(void *))];
+};
+
+TEST_F(BlockEpochTestFixture, register_links_records) {
+    EXPECT_EQ(domain.records, &reader);
+    EXPECT_EQ(reader.next, &writer);
+    EXPECT_EQ(writer.next, nullptr);
+}
+
+TEST_F(BlockEpochTestFixture, retire_keeps_block_intact_until_released) {
+    node_t *node = (node_t *) block_allocate(&pool);
+    node->first  = 1;
+    node->second = 2;
+
+    block_epoch_retire(&domain, &writer, node);
+    EXPECT_EQ(node->first, 1);
+    EXPECT_EQ(node->second, 2);
+    EXPECT_EQ(writer.count, 1);
+    EXPECT_EQ(pool.available, pool.capacity - 1);
+}
+
+TEST_F(BlockEpochTestFixture, reader_inside_critical_section_holds_back_release) {
+    block_epoch_enter(&domain, &reader);
+    block_epoch_retire(&domain, &writer, block_allocate(&pool));
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(block_epoch_poll(&domain, &writer), 0);
+    }
+    EXPECT_EQ(pool.available, pool.capacity - 1);
+
+    block_epoch_exit(&reader);
+    block_epoch_synchronize(&domain, &writer);
+    EXPECT_EQ(writer.count, 0);
+    EXPECT_EQ(pool.available, pool.capacity);
+}
+
+TEST_F(BlockEpochTestFixture, retire_releases_in_batches) {
+    for (int i = 0; i < 4 * BLOCK_EPOCH_BATCH && pool.available > 0; i++) {
+        block_epoch_retire(&domain, &writer, block_allocate(&pool));
+    }
+    EXPECT_LT(writer.count, 2 * BLOCK_EPOCH_BATCH);
+    EXPECT_GT(pool.available, 0);
+
+    block_epoch_synchronize(&domain, &writer);
+    EXPECT_EQ(pool.available, pool.capacity);
+}
+
+TEST_F(BlockEpochTestFixture, readers_never_see_released_nodes) {
+    node_t              *initial = (node_t *) block_allocate(&pool);
+    std::atomic<node_t*> shared(initial);
+    std::atomic<bool>    done(false);
+    std::atomic<int>     torn(0);
+    initial->first  = 0;
+    initial->second = 0;
+
+    std::thread thread([&]() {
+        while (!done) {
+            block_epoch_enter(&domain, &reader);
+            node_t *node = shared.load();
+            uint64_t first = node->first;
+            std::this_thread::yield();
+            if (node->second != first) {
+                torn++;
+            }
+            block_epoch_exit(&reader);
+        }
+    });
+
+    for (uint64_t i = 1; i < 20000; i++) {
+        node_t *node = (node_t *) block_allocate(&pool);
+        if (node == NULL) {
+            block_epoch_poll(&domain, &writer);
+            std::this_thread::yield();
+            continue;
+        }
+        node->first  = i;
+        node->second = i;
+        block_epoch_retire(&domain, &writer, shared.exchange(node));
+    }
+
+    done = true;
+    thread.join();
+    block_epoch_retire(&domain, &writer, shared.load());
+    block_epoch_synchronize(&domain, &writer);
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(pool.available, pool.capacity);
+}
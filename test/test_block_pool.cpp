@@ -4,6 +4,10 @@
 #include "gtest/gtest.h"
 #include "block_pool.h"
 #include "memory.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 typedef union block_header_t block_header_t;
 union block_header_t {
@@ -33,10 +37,10 @@ public:
 
 
     const block_pool_t empty = {
-        .alignment = 0,
         .start = NULL,
-        .end = NULL,
         .search = NULL,
+        .end = NULL,
+        .alignment = 0,
         .capacity = 0,
         .available = 0,
     };
@@ -137,3 +141,139 @@ TEST_F(BlockPoolTestFixture, release_increases_available) {
     block_release(block);
     EXPECT_EQ(expected_available_after_release, pool.available);
 }
+
+TEST_F(BlockPoolTestFixture, allocate_wait_returns_available_block) {
+    InitPool();
+    EXPECT_NE(block_allocate_wait(&pool, 0), nullptr);
+    EXPECT_EQ(block_allocate_wait(NULL, 0), nullptr);
+}
+
+TEST_F(BlockPoolTestFixture, allocate_wait_times_out_on_empty_pool) {
+    InitPool();
+    block_pool_mark_shared(&pool);
+    while (block_allocate(&pool) != NULL);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(block_allocate_wait(&pool, 20000000), nullptr);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(pool.waiters, 0);
+}
+
+TEST_F(BlockPoolTestFixture, allocate_wait_returns_at_once_on_unshared_pool) {
+    InitPool();
+    while (block_allocate(&pool) != NULL);
+
+    // no other thread can release into it, so there is nothing to wait for
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(block_allocate_wait(&pool, UINT64_MAX), nullptr);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_EQ(pool.lock, 0);
+}
+
+TEST_F(BlockPoolTestFixture, release_wakes_one_waiter_per_block) {
+    InitPool();
+    block_pool_mark_shared(&pool);
+    std::vector<void *> blocks;
+    void *block;
+    while ((block = block_allocate(&pool)) != NULL) {
+        blocks.push_back(block);
+    }
+    ASSERT_GE(blocks.size(), 2);
+
+    std::atomic<int> woken(0);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 3; i++) {
+        waiters.emplace_back([this, &woken]() {
+            if (block_allocate_wait(&pool, 500000000) != NULL) {
+                woken++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    block_release(blocks[0]);
+    block_release(blocks[1]);
+
+    for (auto &waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(woken, 2);
+    EXPECT_EQ(pool.available, 0);
+    EXPECT_EQ(pool.waiters, 0);
+}
+
+TEST_F(BlockPoolTestFixture, release_list_returns_every_block) {
+    InitPool();
+    void *list = NULL;
+    void *block;
+    while ((block = block_allocate(&pool)) != NULL) {
+        memset(block, 0xa5, pool.alignment);
+        list = block_list_push(list, block);
+        EXPECT_EQ(*(uint8_t *) block, 0xa5);
+    }
+
+    EXPECT_EQ(block_release_list(NULL, list), 0);
+    EXPECT_EQ(block_release_list(&pool, list), pool.capacity);
+    EXPECT_EQ(pool.available, pool.capacity);
+    EXPECT_EQ(pool.search, (char *) list - sizeof(void *));
+}
+
+TEST_F(BlockPoolTestFixture, reset_rebuilds_empty_pool_at_new_size) {
+    InitPool();
+    void *block = block_allocate(&pool);
+    block_release(block);
+
+    block_pool_reset(&pool, 2 * sizeof(pool));
+    EXPECT_EQ(pool.alignment, 2 * sizeof(pool));
+    EXPECT_EQ(pool.search, pool.start);
+    EXPECT_EQ(pool.capacity, size * sizeof(pool) / (pool.alignment + sizeof(void *)));
+    EXPECT_EQ(pool.available, pool.capacity);
+
+    // back at the original size every block is reachable again
+    block_pool_reset(&pool, sizeof(pool));
+    EXPECT_EQ(pool.capacity, size * sizeof(pool) / (pool.alignment + sizeof(void *)));
+    EXPECT_EQ(pool.available, pool.capacity);
+}
+
+TEST_F(BlockPoolTestFixture, reset_ignores_pool_in_use) {
+    InitPool();
+    void *block = block_allocate(&pool);
+
+    block_pool_reset(&pool, 2 * sizeof(pool));
+    EXPECT_EQ(pool.alignment, sizeof(pool));
+    block_pool_reset(&pool, 0);
+    EXPECT_EQ(pool.alignment, sizeof(pool));
+    block_release(block);
+}
+
+TEST_F(BlockPoolTestFixture, allocate_zeroed_clears_used_blocks) {
+    InitPool();
+    void *block = block_allocate(&pool);
+    memset(block, 0xa5, pool.alignment);
+    block_release(block);
+
+    block_pool_mark_zeroed(&pool);
+    EXPECT_EQ(block_allocate_zeroed(&pool), block);
+    for (size_t i = 0; i < pool.alignment; i++) {
+        EXPECT_EQ(((uint8_t *) block)[i], 0);
+    }
+}
+
+TEST_F(BlockPoolTestFixture, allocate_zeroed_skips_untouched_blocks_of_zeroed_pool) {
+    InitPool();
+    void *first = block_allocate_zeroed(&pool);
+    EXPECT_EQ(pool.untouched, (char *) first + pool.alignment);
+
+    // pretend the memory is zero to see what gets cleared
+    memset(buffer, 0xa5, sizeof(buffer));
+    block_pool_mark_zeroed(&pool);
+    uint8_t *second = (uint8_t *) block_allocate_zeroed(&pool);
+    EXPECT_EQ(second[0], 0xa5);
+    EXPECT_EQ(pool.untouched, second + pool.alignment);
+}
+
+TEST_F(BlockPoolTestFixture, reset_to_new_size_forgets_untouched_memory) {
+    InitPool();
+    block_pool_reset(&pool, 2 * sizeof(pool));
+    EXPECT_EQ(pool.untouched, pool.end);
+}
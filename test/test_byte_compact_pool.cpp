@@ -0,0 +1,142 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <set>
+#include "byte_compact_pool.h"
+
+class ByteCompactPoolTestFixture : public testing::Test {
+public:
+
+    void PoolInit() {
+        byte_compact_pool_init(&pool, buffer, size);
+    }
+
+    const size_t size   = 4096;
+    const size_t header = BYTE_COMPACT_ALIGNMENT;
+
+    byte_compact_pool_t pool = {};
+    alignas(BYTE_COMPACT_ALIGNMENT) uint8_t buffer[4096];
+};
+
+TEST_F(ByteCompactPoolTestFixture, init_ignores_bad_inputs) {
+    byte_compact_pool_t empty = {};
+
+    byte_compact_pool_init(NULL, buffer, size);
+    byte_compact_pool_init(&pool, NULL, size);
+    byte_compact_pool_init(&pool, buffer, 2 * header);
+    EXPECT_EQ(memcmp(&pool, &empty, sizeof(pool)), 0);
+    EXPECT_FALSE(byte_compact_pool_is_valid(&pool));
+}
+
+TEST_F(ByteCompactPoolTestFixture, init_configures_correctly) {
+    PoolInit();
+    EXPECT_TRUE(byte_compact_pool_is_valid(&pool));
+    EXPECT_EQ(pool.start, buffer);
+    EXPECT_EQ(pool.end, buffer + size - header);
+    EXPECT_EQ(pool.capacity, size - 2 * header);
+    EXPECT_EQ(pool.fragments, 1);
+}
+
+TEST_F(ByteCompactPoolTestFixture, init_aligns_memory) {
+    byte_compact_pool_init(&pool, buffer + 1, size - 1);
+    EXPECT_EQ(pool.start, buffer + BYTE_COMPACT_ALIGNMENT);
+    EXPECT_EQ(pool.capacity, size - BYTE_COMPACT_ALIGNMENT - 2 * header);
+}
+
+TEST_F(ByteCompactPoolTestFixture, allocate_uses_eight_byte_headers) {
+    PoolInit();
+    uint8_t *first  = (uint8_t *) byte_compact_allocate(&pool, 24);
+    uint8_t *second = (uint8_t *) byte_compact_allocate(&pool, 17);
+
+    EXPECT_EQ(first, buffer + header);
+    EXPECT_EQ(second, first + 24 + header);
+    EXPECT_EQ(byte_compact_size(&pool, first), 24);
+    EXPECT_EQ(byte_compact_size(&pool, second), 24);
+    EXPECT_EQ(pool.capacity, size - 4 * header - 48);
+    EXPECT_EQ(pool.fragments, 1);
+}
+
+TEST_F(ByteCompactPoolTestFixture, allocate_returns_new_pointer_until_empty) {
+    PoolInit();
+    std::set<void *> allocations;
+    void             *memory;
+
+    while ((memory = byte_compact_allocate(&pool, 24)) != NULL) {
+        EXPECT_TRUE(allocations.insert(memory).second);
+    }
+    EXPECT_EQ(allocations.size(), (size - header) / (24 + header));
+    EXPECT_LT(pool.capacity, 24);
+}
+
+TEST_F(ByteCompactPoolTestFixture, release_coalesces_with_both_neighbours) {
+    PoolInit();
+    void *a = byte_compact_allocate(&pool, 64);
+    void *b = byte_compact_allocate(&pool, 64);
+    void *c = byte_compact_allocate(&pool, 64);
+    void *d = byte_compact_allocate(&pool, 64);
+    EXPECT_EQ(pool.fragments, 1);
+
+    byte_compact_release(&pool, a);
+    EXPECT_EQ(pool.fragments, 2);
+    byte_compact_release(&pool, c);
+    EXPECT_EQ(pool.fragments, 3);
+    byte_compact_release(&pool, b);
+    EXPECT_EQ(pool.fragments, 2);
+    byte_compact_release(&pool, d);
+    EXPECT_EQ(pool.fragments, 1);
+    EXPECT_EQ(pool.capacity, size - 2 * header);
+
+    // whole pool is a single block again
+    EXPECT_EQ(byte_compact_allocate(&pool, size - 2 * header), buffer + header);
+    EXPECT_EQ(pool.fragments, 0);
+}
+
+TEST_F(ByteCompactPoolTestFixture, release_ignores_memory_not_allocated) {
+    PoolInit();
+    uint8_t *memory = (uint8_t *) byte_compact_allocate(&pool, 64);
+    byte_compact_release(&pool, memory);
+    byte_compact_pool_t before = pool;
+
+    byte_compact_release(&pool, NULL);
+    byte_compact_release(&pool, memory);
+    byte_compact_release(&pool, memory + 1);
+    byte_compact_release(&pool, buffer + size);
+    EXPECT_EQ(memcmp(&before, &pool, sizeof(pool)), 0);
+
+    EXPECT_EQ(byte_compact_size(&pool, memory), 0);
+    EXPECT_EQ(byte_compact_size(&pool, NULL), 0);
+}
+
+TEST_F(ByteCompactPoolTestFixture, release_ignores_interior_pointers) {
+    PoolInit();
+    uint8_t *memory = (uint8_t *) byte_compact_allocate(&pool, 64);
+    uint8_t *after  = (uint8_t *) byte_compact_allocate(&pool, 64);
+    memset(memory, 0, 64);
+
+    // payload words that pass for an allocated header without neighbours linking to it
+    uint32_t offset = (uint32_t) (memory + 16 - buffer);
+    uint32_t fake[2] = {offset + 24, 0};
+    memcpy(memory + 16, fake, sizeof(fake));
+
+    byte_compact_pool_t before = pool;
+    byte_compact_release(&pool, memory + 24);
+    EXPECT_EQ(memcmp(&before, &pool, sizeof(pool)), 0);
+    EXPECT_EQ(byte_compact_size(&pool, memory + 24), 0);
+
+    // the real blocks still release
+    EXPECT_EQ(byte_compact_size(&pool, memory), 64);
+    byte_compact_release(&pool, memory);
+    byte_compact_release(&pool, after);
+    EXPECT_EQ(pool.capacity, size - 2 * header);
+}
+
+TEST_F(ByteCompactPoolTestFixture, allocate_wraps_around_to_released_memory) {
+    PoolInit();
+    void *first = byte_compact_allocate(&pool, 256);
+    while (byte_compact_allocate(&pool, 256) != NULL) {}
+
+    byte_compact_release(&pool, first);
+    EXPECT_EQ(byte_compact_allocate(&pool, 256), first);
+}
@@ -0,0 +1,141 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <set>
+#include "byte_map_pool.h"
+
+class ByteMapPoolTestFixture : public testing::Test {
+public:
+
+    void PoolInit() {
+        byte_map_pool_init(&pool, metadata, sizeof(metadata), buffer, size);
+    }
+
+    const size_t size = 4096;
+
+    byte_map_pool_t pool = {};
+    uint64_t        metadata[BYTE_MAP_METADATA_SIZE(4096) / sizeof(uint64_t)];
+    alignas(BYTE_MAP_GRANULE) uint8_t buffer[4096];
+};
+
+TEST_F(ByteMapPoolTestFixture, init_ignores_bad_inputs) {
+    byte_map_pool_t empty = {};
+
+    byte_map_pool_init(NULL, metadata, sizeof(metadata), buffer, size);
+    byte_map_pool_init(&pool, NULL, sizeof(metadata), buffer, size);
+    byte_map_pool_init(&pool, metadata, sizeof(metadata), NULL, size);
+    byte_map_pool_init(&pool, metadata, sizeof(metadata), buffer, BYTE_MAP_GRANULE - 1);
+    byte_map_pool_init(&pool, metadata, 8, buffer, size);
+    EXPECT_EQ(memcmp(&pool, &empty, sizeof(pool)), 0);
+    EXPECT_FALSE(byte_map_pool_is_valid(&pool));
+}
+
+TEST_F(ByteMapPoolTestFixture, init_configures_correctly) {
+    PoolInit();
+    EXPECT_TRUE(byte_map_pool_is_valid(&pool));
+    EXPECT_EQ(pool.start, buffer);
+    EXPECT_EQ(pool.end, buffer + size);
+    EXPECT_EQ(pool.granules, size / BYTE_MAP_GRANULE);
+    EXPECT_EQ(pool.capacity, size);
+    EXPECT_EQ(pool.fragments, 1);
+}
+
+TEST_F(ByteMapPoolTestFixture, init_aligns_memory_to_granule) {
+    byte_map_pool_init(&pool, metadata, sizeof(metadata), buffer + 1, size - 1);
+    EXPECT_EQ(pool.start, buffer + BYTE_MAP_GRANULE);
+    EXPECT_EQ(pool.capacity, size - BYTE_MAP_GRANULE);
+}
+
+TEST_F(ByteMapPoolTestFixture, allocate_ignores_bad_inputs) {
+    PoolInit();
+    EXPECT_EQ(byte_map_allocate(NULL, 8), nullptr);
+    EXPECT_EQ(byte_map_allocate(&pool, 0), nullptr);
+    EXPECT_EQ(byte_map_allocate(&pool, size + 1), nullptr);
+}
+
+TEST_F(ByteMapPoolTestFixture, allocate_rounds_to_granules_without_headers) {
+    PoolInit();
+    uint8_t *first  = (uint8_t *) byte_map_allocate(&pool, 1);
+    uint8_t *second = (uint8_t *) byte_map_allocate(&pool, BYTE_MAP_GRANULE + 1);
+
+    EXPECT_EQ(first, buffer);
+    EXPECT_EQ(second, buffer + BYTE_MAP_GRANULE);
+    EXPECT_EQ(byte_map_size(&pool, first), BYTE_MAP_GRANULE);
+    EXPECT_EQ(byte_map_size(&pool, second), 2 * BYTE_MAP_GRANULE);
+    EXPECT_EQ(pool.capacity, size - 3 * BYTE_MAP_GRANULE);
+    EXPECT_EQ(pool.fragments, 1);
+}
+
+TEST_F(ByteMapPoolTestFixture, allocate_returns_new_pointer_until_empty) {
+    PoolInit();
+    std::set<void *> allocations;
+    void             *memory;
+
+    while ((memory = byte_map_allocate(&pool, 48)) != NULL) {
+        EXPECT_TRUE(allocations.insert(memory).second);
+    }
+    EXPECT_EQ(allocations.size(), size / 48);
+    EXPECT_LT(pool.capacity, 48);
+}
+
+TEST_F(ByteMapPoolTestFixture, release_coalesces_with_both_neighbours) {
+    PoolInit();
+    void *a = byte_map_allocate(&pool, 64);
+    void *b = byte_map_allocate(&pool, 64);
+    void *c = byte_map_allocate(&pool, 64);
+    void *d = byte_map_allocate(&pool, 64);
+    EXPECT_EQ(pool.fragments, 1);
+
+    byte_map_release(&pool, a);
+    EXPECT_EQ(pool.fragments, 2);
+    byte_map_release(&pool, c);
+    EXPECT_EQ(pool.fragments, 3);
+    byte_map_release(&pool, b);
+    EXPECT_EQ(pool.fragments, 2);
+    byte_map_release(&pool, d);
+    EXPECT_EQ(pool.fragments, 1);
+    EXPECT_EQ(pool.capacity, size);
+
+    // whole pool is a single run again
+    EXPECT_NE(byte_map_allocate(&pool, size), nullptr);
+    EXPECT_EQ(pool.fragments, 0);
+}
+
+TEST_F(ByteMapPoolTestFixture, release_ignores_memory_not_allocated) {
+    PoolInit();
+    uint8_t *memory = (uint8_t *) byte_map_allocate(&pool, 64);
+    byte_map_pool_t before = pool;
+
+    byte_map_release(&pool, NULL);
+    byte_map_release(&pool, memory + 1);
+    byte_map_release(&pool, memory + BYTE_MAP_GRANULE);
+    byte_map_release(&pool, memory + 128);
+    EXPECT_EQ(memcmp(&before, &pool, sizeof(pool)), 0);
+
+    EXPECT_EQ(byte_map_size(&pool, memory + BYTE_MAP_GRANULE), 0);
+    EXPECT_EQ(byte_map_size(&pool, NULL), 0);
+}
+
+TEST_F(ByteMapPoolTestFixture, allocate_wraps_around_to_released_memory) {
+    PoolInit();
+    void *first = byte_map_allocate(&pool, 256);
+    while (byte_map_allocate(&pool, 256) != NULL) {}
+
+    byte_map_release(&pool, first);
+    EXPECT_EQ(byte_map_allocate(&pool, 256), first);
+}
+
+TEST_F(ByteMapPoolTestFixture, allocate_finds_runs_spanning_bitmap_words) {
+    PoolInit();
+    void *allocations[8];
+    for (auto &allocation : allocations) {
+        allocation = byte_map_allocate(&pool, 40 * BYTE_MAP_GRANULE);
+    }
+
+    // free two neighbours so the only fitting run crosses a 64 granule word boundary
+    byte_map_release(&pool, allocations[1]);
+    byte_map_release(&pool, allocations[2]);
+    EXPECT_EQ(byte_map_allocate(&pool, 70 * BYTE_MAP_GRANULE), allocations[1]);
+}
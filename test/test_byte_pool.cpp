@@ -75,7 +75,7 @@ TEST_F(BytePoolTestFixture, private_byte_block_is_free) {
 }
 
 TEST_F(BytePoolTestFixture, private_byte_block_is_valid) {
-    byte_header_t block = {.owner = NULL, .next = NULL};
+    byte_header_t block = {.next = NULL, .owner = NULL};
     byte_header_t next;
     EXPECT_FALSE(byte_block_is_valid(NULL));
     EXPECT_FALSE(byte_block_is_valid(&block));
@@ -84,7 +84,7 @@ TEST_F(BytePoolTestFixture, private_byte_block_is_valid) {
 }
 
 TEST_F(BytePoolTestFixture, private_byte_block_get_size) {
-    byte_header_t block      = {.owner = &pool, .next = NULL};
+    byte_header_t block      = {.next = NULL, .owner = &pool};
     byte_header_t *block_ptr = &block;
     byte_header_t *next      = block_ptr + 2;
     EXPECT_EQ(byte_block_get_size(NULL), 0);
@@ -95,12 +95,12 @@ TEST_F(BytePoolTestFixture, private_byte_block_get_size) {
 
 TEST_F(BytePoolTestFixture, private_byte_block_merge_next) {
     byte_header_t block[6] = {
-        {.owner = &pool, .next = &block[2]},
-        {.owner = NULL, .next = NULL},
-        {.owner = NULL, .next = &block[4]},
-        {.owner = NULL, .next = NULL},
-        {.owner = NULL, .next = &block[5]},
-        {.owner = NULL, .next = NULL}};
+        {.next = &block[2], .owner = &pool},
+        {.next = NULL, .owner = NULL},
+        {.next = &block[4], .owner = NULL},
+        {.next = NULL, .owner = NULL},
+        {.next = &block[5], .owner = NULL},
+        {.next = NULL, .owner = NULL}};
     byte_header_t *first   = block;
     byte_header_t *second  = &block[2];
     byte_header_t *third   = &block[4];
@@ -150,12 +150,12 @@ TEST_F(BytePoolTestFixture, private_byte_block_needs_split) {
 
 TEST_F(BytePoolTestFixture, private_byte_block_split) {
     byte_header_t block[6] = {
-        {.owner = &pool, .next = &block[4]},
-        {.owner = NULL, .next = NULL},
-        {.owner = NULL, .next = NULL},
-        {.owner = NULL, .next = NULL},
-        {.owner = NULL, .next = &block[5]},
-        {.owner = NULL, .next = NULL}};
+        {.next = &block[4], .owner = &pool},
+        {.next = NULL, .owner = NULL},
+        {.next = NULL, .owner = NULL},
+        {.next = NULL, .owner = NULL},
+        {.next = &block[5], .owner = NULL},
+        {.next = NULL, .owner = NULL}};
     byte_header_t *first   = block;
     byte_header_t *second  = &block[2];
     byte_header_t *third   = &block[4];
@@ -297,6 +297,34 @@ TEST_F(BytePoolTestFixture, allocate_moves_search_pointer) {
     EXPECT_EQ(expected_search_pointer_after_allocate, pool.search);
 }
 
+TEST_F(BytePoolTestFixture, allocate_splits_free_blocks_over_stale_data) {
+    PoolInit();
+    uint8_t *memory = (uint8_t *) byte_allocate(&pool, 128);
+    memset(memory, 0xa5, 128);
+    byte_release(memory);
+
+    // the header split off lands in old payload bytes and must not look allocated
+    EXPECT_EQ(byte_allocate(&pool, 32), memory);
+    EXPECT_EQ(byte_allocate(&pool, 32), memory + 32 + sizeof(byte_header_t));
+    EXPECT_EQ(pool.capacity, size - 4 * sizeof(byte_header_t) - 64);
+}
+
+TEST_F(BytePoolTestFixture, allocate_resumes_after_last_allocated_block) {
+    PoolInit();
+    uint8_t *first  = (uint8_t *) byte_allocate(&pool, 16);
+    uint8_t *second = (uint8_t *) byte_allocate(&pool, 16);
+    byte_release(first);
+    pool.search = get_header_from_memory(first);
+
+    // the hole at first is too small, so the block lands after second
+    uint8_t *large = (uint8_t *) byte_allocate(&pool, 64);
+    EXPECT_EQ(large, second + 16 + sizeof(byte_header_t));
+    EXPECT_EQ((uint8_t *) pool.search, large + 64);
+
+    // the next search starts past large instead of going back to the hole
+    EXPECT_EQ(byte_allocate(&pool, 16), large + 64 + sizeof(byte_header_t));
+}
+
 TEST_F(BytePoolTestFixture, allocate_returns_new_pointer_until_empty) {
     PoolInit();
 
@@ -372,4 +400,260 @@ TEST_F(BytePoolTestFixture, byte_size_returns_correct_size_for_allocated_memory)
     // non-free blocks should return correct size
     byte_allocate(&pool, 32);
     EXPECT_EQ(byte_size(((byte_header_t*)pool.start)+1), 32);
-}
\ No newline at end of file
+}
+
+TEST_F(BytePoolTestFixture, allocate_wraps_around_to_blocks_released_behind_search) {
+    PoolInit();
+    void *first = byte_allocate(&pool, 32);
+    while (byte_allocate(&pool, 32) != NULL) {}
+
+    byte_release(first);
+    EXPECT_EQ(byte_allocate(&pool, 32), first);
+}
+
+TEST_F(BytePoolTestFixture, release_batch_ignores_bad_inputs) {
+    PoolInit();
+    void *memory = byte_allocate(&pool, 32);
+    void *ptrs[] = {NULL, memory, memory};
+    byte_pool_t before;
+
+    byte_release(memory);
+    before = pool;
+    EXPECT_EQ(byte_release_batch(NULL, 3), 0);
+    EXPECT_EQ(byte_release_batch(ptrs, 0), 0);
+    EXPECT_EQ(byte_release_batch(ptrs, 3), 0);
+    EXPECT_EQ(memcmp(&before, &pool, sizeof(pool)), 0);
+}
+
+TEST_F(BytePoolTestFixture, release_batch_coalesces_with_previous_neighbours) {
+    PoolInit();
+    void *a = byte_allocate(&pool, 32);
+    void *b = byte_allocate(&pool, 32);
+    void *c = byte_allocate(&pool, 32);
+    void *d = byte_allocate(&pool, 32);
+    void *ptrs[] = {d, NULL, a, c, a};
+
+    // b is free ahead of the batch and only merges once a is freed behind it
+    byte_release(b);
+    EXPECT_EQ(byte_release_batch(ptrs, 5), 3);
+    EXPECT_EQ(pool.fragments, 1);
+    EXPECT_EQ(pool.capacity, size - 2 * sizeof(byte_header_t));
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+    EXPECT_EQ(byte_allocate(&pool, pool.capacity), a);
+}
+
+TEST_F(BytePoolTestFixture, release_batch_leaves_allocated_blocks_in_place) {
+    PoolInit();
+    void *a = byte_allocate(&pool, 32);
+    void *b = byte_allocate(&pool, 32);
+    void *c = byte_allocate(&pool, 32);
+    void *ptrs[] = {c, a};
+
+    EXPECT_EQ(byte_release_batch(ptrs, 2), 2);
+    EXPECT_EQ(byte_size(b), 32);
+    EXPECT_EQ(pool.fragments, 3);
+    EXPECT_EQ(pool.capacity, size - 4 * sizeof(byte_header_t) - 32);
+
+    // the search pointer followed the tail block into c's run
+    EXPECT_EQ(pool.search, get_header_from_memory(c));
+    EXPECT_EQ(byte_allocate(&pool, 32), c);
+}
+
+TEST_F(BytePoolTestFixture, allocate_zeroed_clears_used_memory) {
+    PoolInit();
+    uint8_t *memory = (uint8_t *) byte_allocate(&pool, 64);
+    memset(memory, 0xa5, 64);
+    byte_release(memory);
+
+    byte_pool_mark_zeroed(&pool);
+    EXPECT_EQ(byte_allocate_zeroed(&pool, 48), memory);
+    for (int i = 0; i < 48; i++) {
+        EXPECT_EQ(memory[i], 0);
+    }
+}
+
+TEST_F(BytePoolTestFixture, allocate_zeroed_clears_only_used_part_of_zeroed_pool) {
+    PoolInit();
+    uint8_t *first = (uint8_t *) byte_allocate(&pool, 32);
+    EXPECT_EQ(pool.untouched, first + 32 + sizeof(byte_header_t));
+    byte_release(first);
+
+    // pretend the memory is zero to see what gets cleared, the header after first merges into the next block
+    memset(first + 32 + sizeof(byte_header_t), 0xa5, size - 4 * sizeof(byte_header_t) - 32);
+    byte_pool_mark_zeroed(&pool);
+    uint8_t *memory = (uint8_t *) byte_allocate_zeroed(&pool, 64);
+    ASSERT_EQ(memory, first);
+    EXPECT_EQ(memory[47], 0);
+    EXPECT_EQ(memory[48], 0xa5);
+}
+
+TEST(BytePoolZeroTest, allocate_zeroed_clears_large_blocks) {
+    alignas(sizeof(void *)) static uint8_t buffer[1024 * 1024];
+    byte_pool_t                            pool;
+
+    memset(buffer, 0xa5, sizeof(buffer));
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    uint8_t *memory = (uint8_t *) byte_allocate_zeroed(&pool, 512 * 1024);
+    ASSERT_NE(memory, nullptr);
+    for (size_t i = 0; i < 512 * 1024; i++) {
+        ASSERT_EQ(memory[i], 0);
+    }
+}
+
+TEST(BytePoolZeroTest, allocate_zeroed_rounds_unaligned_tails) {
+    alignas(sizeof(void *)) uint8_t buffer[512];
+    byte_pool_t                     pool;
+
+    memset(buffer, 0xa5, sizeof(buffer));
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    uint8_t *memory = (uint8_t *) byte_allocate_zeroed(&pool, 13);
+    uint8_t *next   = (uint8_t *) byte_allocate_zeroed(&pool, 3);
+    ASSERT_NE(memory, nullptr);
+    ASSERT_NE(next, nullptr);
+
+    // the tail is rounded to a whole word so the following header stays aligned
+    EXPECT_EQ(byte_size(memory), 16);
+    EXPECT_EQ((uintptr_t) next % sizeof(void *), 0);
+    for (size_t i = 0; i < 16; i++) {
+        EXPECT_EQ(memory[i], 0);
+    }
+    for (size_t i = 0; i < sizeof(void *); i++) {
+        EXPECT_EQ(next[i], 0);
+    }
+}
+
+class ByteHandleTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        byte_pool_init(&pool, buffer, sizeof(buffer));
+        byte_handle_table_init(&table, &pool, entries, 8);
+    }
+
+    byte_pool_t         pool = {};
+    byte_handle_table_t table = {};
+    byte_handle_entry_t entries[8];
+    uint8_t             buffer[512];
+};
+
+TEST_F(ByteHandleTestFixture, allocate_ignores_bad_inputs) {
+    EXPECT_EQ(byte_handle_allocate(NULL, 16), nullptr);
+    EXPECT_EQ(byte_handle_allocate(&table, 0), nullptr);
+    EXPECT_EQ(byte_handle_allocate(&table, sizeof(buffer)), nullptr);
+    EXPECT_EQ(byte_handle_lock(NULL), nullptr);
+    EXPECT_EQ(byte_pool_compact(NULL), 0);
+}
+
+TEST_F(ByteHandleTestFixture, allocate_runs_out_of_handles) {
+    for (int i = 0; i < 8; i++) {
+        EXPECT_NE(byte_handle_allocate(&table, 8), nullptr);
+    }
+    EXPECT_EQ(byte_handle_allocate(&table, 8), nullptr);
+}
+
+TEST_F(ByteHandleTestFixture, lock_returns_stable_memory) {
+    byte_handle_t handle = byte_handle_allocate(&table, 32);
+    uint8_t *memory = (uint8_t *) byte_handle_lock(handle);
+    ASSERT_NE(memory, nullptr);
+    memset(memory, 0x5a, 32);
+    EXPECT_EQ(byte_handle_lock(handle), memory);
+    EXPECT_EQ(handle->locks, 2);
+
+    byte_handle_release(&table, handle);
+    EXPECT_EQ(byte_handle_lock(handle), memory);
+
+    byte_handle_unlock(handle);
+    byte_handle_unlock(handle);
+    byte_handle_unlock(handle);
+    byte_handle_unlock(handle);
+    EXPECT_EQ(handle->locks, 0);
+    byte_handle_release(&table, handle);
+    EXPECT_EQ(byte_handle_lock(handle), nullptr);
+}
+
+TEST_F(ByteHandleTestFixture, byte_release_ignores_handle_memory) {
+    byte_handle_t handle   = byte_handle_allocate(&table, 32);
+    void          *memory  = byte_handle_lock(handle);
+    size_t        capacity = pool.capacity;
+
+    // only the table may release handle memory
+    byte_release(memory);
+    EXPECT_EQ(byte_size(memory), 0);
+    EXPECT_EQ(byte_release_batch(&memory, 1), 0);
+    EXPECT_EQ(pool.capacity, capacity);
+    EXPECT_EQ(byte_handle_lock(handle), memory);
+
+    byte_handle_unlock(handle);
+    byte_handle_unlock(handle);
+    byte_handle_release(&table, handle);
+    EXPECT_GT(pool.capacity, capacity);
+}
+
+TEST_F(ByteHandleTestFixture, compact_moves_unlocked_memory_to_the_start) {
+    byte_handle_t handles[6];
+    for (int i = 0; i < 6; i++) {
+        handles[i] = byte_handle_allocate(&table, 48);
+        memset(byte_handle_lock(handles[i]), i, 48);
+        byte_handle_unlock(handles[i]);
+    }
+    byte_handle_release(&table, handles[0]);
+    byte_handle_release(&table, handles[2]);
+    byte_handle_release(&table, handles[4]);
+
+    EXPECT_EQ(byte_pool_compact(&table), 3);
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+    EXPECT_EQ(pool.fragments, 4);
+    EXPECT_EQ(pool.capacity, sizeof(buffer) - 5 * 16 - 3 * 48);
+
+    for (int i = 1; i < 6; i += 2) {
+        uint8_t *memory = (uint8_t *) byte_handle_lock(handles[i]);
+        EXPECT_EQ(memory, buffer + 16 + (i / 2) * 64);
+        EXPECT_EQ(memory[0], i);
+        EXPECT_EQ(memory[47], i);
+        byte_handle_unlock(handles[i]);
+    }
+
+    // the free space is a single block again
+    EXPECT_NE(byte_allocate(&pool, pool.capacity), nullptr);
+}
+
+TEST_F(ByteHandleTestFixture, compact_leaves_locked_and_raw_memory_in_place) {
+    byte_handle_t first  = byte_handle_allocate(&table, 48);
+    byte_handle_t locked = byte_handle_allocate(&table, 48);
+    void          *raw   = byte_allocate(&pool, 48);
+    byte_handle_t middle = byte_handle_allocate(&table, 48);
+    byte_handle_t last   = byte_handle_allocate(&table, 48);
+    void          *pinned = byte_handle_lock(locked);
+    void          *moved_to = byte_handle_lock(middle);
+
+    byte_handle_unlock(middle);
+    byte_handle_release(&table, first);
+    byte_handle_release(&table, middle);
+    EXPECT_EQ(byte_pool_compact(&table), 1);
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+
+    EXPECT_EQ(byte_handle_lock(locked), pinned);
+    EXPECT_EQ(byte_size(raw), 48);
+    EXPECT_EQ(byte_handle_lock(last), moved_to);
+
+    // space freed in front of the locked block is still usable
+    EXPECT_EQ(byte_allocate(&pool, 48), buffer + 16);
+    byte_release(raw);
+    EXPECT_EQ(byte_size(raw), 0);
+}
+
+TEST_F(ByteHandleTestFixture, allocate_compacts_when_fragmented) {
+    byte_handle_t handles[8];
+    int           count = 0;
+    while (count < 8 && (handles[count] = byte_handle_allocate(&table, 40)) != NULL) {
+        count++;
+    }
+    for (int i = 0; i < count; i += 2) {
+        byte_handle_release(&table, handles[i]);
+    }
+    byte_pool_defragment(&pool);
+
+    EXPECT_EQ(byte_allocate(&pool, 4 * 40), nullptr);
+    EXPECT_NE(byte_handle_allocate(&table, 4 * 40), nullptr);
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+}
@@ -0,0 +1,173 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "cpool_malloc.h"
+
+class CpoolMallocTestFixture : public testing::Test {
+public:
+    static bool Aligned(void *memory, size_t alignment) {
+        return ((uintptr_t) memory & (alignment - 1)) == 0;
+    }
+};
+
+TEST_F(CpoolMallocTestFixture, malloc_serves_every_size_range) {
+    const size_t sizes[] = {0, 1, 16, 24, 100, 1000, 1032, 1033, 4096, 100000, CPOOL_MALLOC_HUGE,
+                            CPOOL_MALLOC_HUGE + 1, 4 << 20};
+    for (size_t size : sizes) {
+        char *memory = (char *) cpool_malloc(size);
+        ASSERT_NE(memory, nullptr) << size;
+        EXPECT_TRUE(Aligned(memory, 16)) << size;
+        EXPECT_GE(cpool_malloc_usable_size(memory), size);
+        memset(memory, 0xA5, size);
+        cpool_free(memory);
+    }
+}
+
+TEST_F(CpoolMallocTestFixture, free_ignores_null) {
+    cpool_free(NULL);
+    EXPECT_EQ(cpool_malloc_usable_size(NULL), 0);
+}
+
+TEST_F(CpoolMallocTestFixture, free_ignores_foreign_pointers) {
+    alignas(16) uintptr_t foreign[8] = {};
+
+    // looks like a huge mapping header but lacks the magic
+    foreign[2] = (uintptr_t) foreign;
+    foreign[3] = sizeof(foreign);
+    cpool_free(&foreign[6]);
+    EXPECT_EQ(cpool_malloc_usable_size(&foreign[6]), 0);
+    EXPECT_EQ(foreign[2], (uintptr_t) foreign);
+
+    char *huge = (char *) cpool_malloc(CPOOL_MALLOC_HUGE + 1);
+    ASSERT_NE(huge, nullptr);
+    EXPECT_EQ(cpool_malloc_usable_size(huge + 16), 0);
+    cpool_free(huge);
+}
+
+TEST_F(CpoolMallocTestFixture, allocations_do_not_overlap) {
+    std::vector<char *> allocations;
+    for (int i = 0; i < 2000; i++) {
+        size_t size = 1 + (i * 37) % 3000;
+        char   *memory = (char *) cpool_malloc(size);
+        ASSERT_NE(memory, nullptr);
+        memset(memory, i & 0xFF, size);
+        allocations.push_back(memory);
+    }
+    for (int i = 0; i < 2000; i++) {
+        size_t size = 1 + (i * 37) % 3000;
+        for (size_t j = 0; j < size; j++) {
+            ASSERT_EQ((unsigned char) allocations[i][j], i & 0xFF);
+        }
+        cpool_free(allocations[i]);
+    }
+}
+
+TEST_F(CpoolMallocTestFixture, calloc_returns_zeroed_memory) {
+    char *dirty = (char *) cpool_malloc(200);
+    memset(dirty, 0xFF, 200);
+    cpool_free(dirty);
+
+    char *memory = (char *) cpool_calloc(50, 4);
+    ASSERT_NE(memory, nullptr);
+    for (int i = 0; i < 200; i++) {
+        EXPECT_EQ(memory[i], 0);
+    }
+    cpool_free(memory);
+}
+
+TEST_F(CpoolMallocTestFixture, calloc_rejects_overflow) {
+    errno = 0;
+    EXPECT_EQ(cpool_calloc(SIZE_MAX / 2, 4), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+}
+
+TEST_F(CpoolMallocTestFixture, realloc_preserves_contents_across_engines) {
+    char *memory = (char *) cpool_realloc(NULL, 10);
+    ASSERT_NE(memory, nullptr);
+    memcpy(memory, "cpool", 6);
+
+    const size_t sizes[] = {20, 2000, 300000, 64};
+    for (size_t size : sizes) {
+        memory = (char *) cpool_realloc(memory, size);
+        ASSERT_NE(memory, nullptr);
+        EXPECT_STREQ(memory, "cpool");
+    }
+
+    EXPECT_EQ(cpool_realloc(memory, 0), nullptr);
+}
+
+TEST_F(CpoolMallocTestFixture, posix_memalign_honours_alignment) {
+    void *memory;
+
+    EXPECT_EQ(cpool_posix_memalign(&memory, 3, 16), EINVAL);
+    EXPECT_EQ(cpool_posix_memalign(&memory, 4, 16), EINVAL);
+
+    for (size_t alignment = sizeof(void *); alignment <= 8192; alignment *= 2) {
+        const size_t sizes[] = {1, 100, 5000};
+        for (size_t size : sizes) {
+            ASSERT_EQ(cpool_posix_memalign(&memory, alignment, size), 0);
+            EXPECT_TRUE(Aligned(memory, alignment)) << alignment;
+            EXPECT_GE(cpool_malloc_usable_size(memory), size);
+            memset(memory, 0x5A, size);
+            cpool_free(memory);
+        }
+    }
+
+    memory = cpool_aligned_alloc(64, 64);
+    EXPECT_TRUE(Aligned(memory, 64));
+    cpool_free(memory);
+}
+
+TEST_F(CpoolMallocTestFixture, posix_memalign_rejects_huge_sizes) {
+    void *memory = nullptr;
+
+    // size + alignment wraps around, none of these may land in a size class
+    EXPECT_EQ(cpool_posix_memalign(&memory, 32, SIZE_MAX - 10), ENOMEM);
+    EXPECT_EQ(cpool_posix_memalign(&memory, 4096, SIZE_MAX - 100), ENOMEM);
+    EXPECT_EQ(cpool_posix_memalign(&memory, (SIZE_MAX >> 1) + 1, 16), ENOMEM);
+    EXPECT_EQ(cpool_aligned_alloc(64, SIZE_MAX - 40), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+}
+
+TEST_F(CpoolMallocTestFixture, freed_small_blocks_are_reused) {
+    void *first = cpool_malloc(40);
+    cpool_free(first);
+    EXPECT_EQ(cpool_malloc(40), first);
+    cpool_free(first);
+}
+
+TEST_F(CpoolMallocTestFixture, concurrent_allocate_and_free) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t]() {
+            void *slots[256] = {};
+            uint32_t seed = 1234 + t;
+            for (int i = 0; i < 100000; i++) {
+                seed = seed * 1103515245 + 12345;
+                int slot = (seed >> 8) % 256;
+                if (slots[slot] != NULL) {
+                    ASSERT_EQ(*(int *) slots[slot], slot);
+                    cpool_free(slots[slot]);
+                    slots[slot] = NULL;
+                } else {
+                    slots[slot] = cpool_malloc(sizeof(int) + (seed >> 16) % 4000);
+                    ASSERT_NE(slots[slot], nullptr);
+                    *(int *) slots[slot] = slot;
+                }
+            }
+            for (void *slot : slots) {
+                cpool_free(slot);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
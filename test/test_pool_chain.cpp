@@ -0,0 +1,122 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+#include "pool_chain.h"
+
+static int system_allocations = 0;
+
+static void *system_allocate(size_t size) {
+    system_allocations++;
+    return malloc(size);
+}
+
+static void system_release(void *memory) {
+    system_allocations--;
+    free(memory);
+}
+
+class PoolChainTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        system_allocations = 0;
+        block_pool_init(&small, 16, small_buffer, small_buffer + sizeof(small_buffer));
+        block_pool_init(&large, 64, large_buffer, large_buffer + sizeof(large_buffer));
+        byte_pool_init(&bytes, byte_buffer, sizeof(byte_buffer));
+        pool_chain_init(&chain, index, 4);
+    }
+
+    pool_chain_t chain = {};
+    pool_tier_t  *index[4];
+    pool_tier_t  tiers[4];
+
+    block_pool_t small = {};
+    block_pool_t large = {};
+    byte_pool_t  bytes = {};
+
+    alignas(16) uint8_t small_buffer[4 * 24];
+    alignas(16) uint8_t large_buffer[4 * 72];
+    alignas(16) uint8_t byte_buffer[512];
+};
+
+TEST_F(PoolChainTestFixture, add_ignores_bad_inputs) {
+    block_pool_t invalid = {};
+    EXPECT_FALSE(pool_chain_add_block(NULL, &tiers[0], &small));
+    EXPECT_FALSE(pool_chain_add_block(&chain, NULL, &small));
+    EXPECT_FALSE(pool_chain_add_block(&chain, &tiers[0], &invalid));
+    EXPECT_FALSE(pool_chain_add_system(&chain, &tiers[0], NULL, free));
+    EXPECT_EQ(chain.first, nullptr);
+    EXPECT_EQ(chain.count, 0);
+}
+
+TEST_F(PoolChainTestFixture, add_rejects_overlapping_pools_and_full_index) {
+    block_pool_t overlap = {};
+    block_pool_init(&overlap, 16, small_buffer + 24, small_buffer + sizeof(small_buffer));
+
+    pool_chain_init(&chain, index, 2);
+    EXPECT_TRUE(pool_chain_add_block(&chain, &tiers[0], &small));
+    EXPECT_FALSE(pool_chain_add_block(&chain, &tiers[1], &overlap));
+    EXPECT_TRUE(pool_chain_add_byte(&chain, &tiers[1], &bytes));
+    EXPECT_FALSE(pool_chain_add_block(&chain, &tiers[2], &large));
+    EXPECT_TRUE(pool_chain_add_system(&chain, &tiers[2], system_allocate, system_release));
+    EXPECT_FALSE(pool_chain_add_system(&chain, &tiers[3], system_allocate, system_release));
+}
+
+TEST_F(PoolChainTestFixture, allocate_skips_tiers_too_small) {
+    pool_chain_add_block(&chain, &tiers[0], &small);
+    pool_chain_add_block(&chain, &tiers[1], &large);
+
+    void *memory = pool_chain_allocate(&chain, 32);
+    EXPECT_EQ(pool_chain_owner(&chain, memory), &tiers[1]);
+    EXPECT_EQ(pool_chain_allocate(&chain, 128), nullptr);
+    EXPECT_EQ(chain.spills, 0);
+}
+
+TEST_F(PoolChainTestFixture, allocate_spills_through_every_tier) {
+    pool_chain_add_block(&chain, &tiers[0], &small);
+    pool_chain_add_block(&chain, &tiers[1], &large);
+    pool_chain_add_byte(&chain, &tiers[2], &bytes);
+    pool_chain_add_system(&chain, &tiers[3], system_allocate, system_release);
+
+    std::vector<void *> memory;
+    int                 owners[4] = {};
+    for (int i = 0; i < 32; i++) {
+        memory.push_back(pool_chain_allocate(&chain, 16));
+        ASSERT_NE(memory.back(), nullptr);
+        owners[pool_chain_owner(&chain, memory.back()) - tiers]++;
+    }
+
+    EXPECT_EQ(owners[0], small.capacity);
+    EXPECT_EQ(owners[1], large.capacity);
+    EXPECT_GT(owners[2], 0);
+    EXPECT_GT(owners[3], 0);
+    EXPECT_EQ(system_allocations, owners[3]);
+    EXPECT_EQ(chain.spills, 32 - small.capacity);
+
+    for (void *m : memory) {
+        pool_chain_release(&chain, m);
+    }
+    EXPECT_EQ(small.available, small.capacity);
+    EXPECT_EQ(large.available, large.capacity);
+    EXPECT_EQ(system_allocations, 0);
+    byte_pool_defragment(&bytes);
+    EXPECT_EQ(bytes.fragments, 1);
+}
+
+TEST_F(PoolChainTestFixture, owner_finds_tier_by_address) {
+    pool_chain_add_byte(&chain, &tiers[0], &bytes);
+    pool_chain_add_block(&chain, &tiers[1], &large);
+    pool_chain_add_block(&chain, &tiers[2], &small);
+
+    EXPECT_EQ(pool_chain_owner(&chain, small_buffer), &tiers[2]);
+    EXPECT_EQ(pool_chain_owner(&chain, large_buffer + sizeof(large_buffer) - 1), &tiers[1]);
+    EXPECT_EQ(pool_chain_owner(&chain, byte_buffer + 100), &tiers[0]);
+    EXPECT_EQ(pool_chain_owner(&chain, &chain), nullptr);
+
+    pool_chain_add_system(&chain, &tiers[3], system_allocate, system_release);
+    EXPECT_EQ(pool_chain_owner(&chain, &chain), &tiers[3]);
+}
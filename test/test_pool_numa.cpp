@@ -0,0 +1,147 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+#include "pool_numa.h"
+
+class PoolNumaTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        pool_numa_set_init(&set);
+        for (size_t node = 0; node < 2; node++) {
+            block_pool_init(&blocks[node], 32, block_memory[node], block_memory[node] + sizeof(block_memory[node]));
+            byte_pool_init(&bytes[node], byte_memory[node], sizeof(byte_memory[node]));
+        }
+    }
+
+    pool_numa_set_t set;
+    block_pool_t    blocks[2];
+    byte_pool_t     bytes[2];
+    alignas(32) uint8_t block_memory[2][256];
+    alignas(sizeof(void *)) uint8_t byte_memory[2][512];
+};
+
+TEST_F(PoolNumaTestFixture, topology_falls_back_to_one_node) {
+    size_t nodes = pool_numa_nodes();
+
+    EXPECT_GE(nodes, 1);
+    EXPECT_LT(pool_numa_current(), nodes);
+    if (nodes == 1) {
+        EXPECT_FALSE(pool_numa_bind(block_memory, sizeof(block_memory), 0));
+        EXPECT_FALSE(pool_numa_prefer(0));
+    }
+    EXPECT_FALSE(pool_numa_bind(NULL, 4096, 0));
+    EXPECT_FALSE(pool_numa_bind(block_memory, sizeof(block_memory), POOL_NUMA_MAX));
+}
+
+TEST_F(PoolNumaTestFixture, set_add_ignores_bad_inputs) {
+    block_pool_t empty = {};
+
+    EXPECT_FALSE(pool_numa_set_add(NULL, 0, &blocks[0], &bytes[0]));
+    EXPECT_FALSE(pool_numa_set_add(&set, POOL_NUMA_MAX, &blocks[0], &bytes[0]));
+    EXPECT_FALSE(pool_numa_set_add(&set, 0, &empty, NULL));
+    EXPECT_FALSE(pool_numa_set_add(&set, 0, NULL, NULL));
+    EXPECT_EQ(set.count, 0);
+    EXPECT_EQ(pool_numa_block_allocate(&set), nullptr);
+    EXPECT_EQ(pool_numa_byte_allocate(&set, 8), nullptr);
+}
+
+TEST_F(PoolNumaTestFixture, allocate_spills_to_other_nodes) {
+    std::set<void *> allocations;
+    void             *memory;
+    size_t           local;
+    size_t           available = blocks[0].available;
+
+    EXPECT_TRUE(pool_numa_set_add(&set, 0, &blocks[0], &bytes[0]));
+    EXPECT_TRUE(pool_numa_set_add(&set, 1, &blocks[1], &bytes[1]));
+    EXPECT_EQ(set.count, 2);
+    EXPECT_TRUE(blocks[0].shared);
+    EXPECT_TRUE(blocks[1].shared);
+
+    local = pool_numa_current() % set.count;
+    while ((memory = pool_numa_block_allocate(&set)) != NULL) {
+        EXPECT_TRUE(allocations.insert(memory).second);
+    }
+    EXPECT_EQ(allocations.size(), 2 * available);
+
+    // the local node's pool is used up before any other
+    EXPECT_EQ(set.remote, available);
+    EXPECT_EQ(blocks[local].available, 0);
+
+    for (void *allocation : allocations) {
+        block_release(allocation);
+    }
+    EXPECT_EQ(blocks[0].available, available);
+    EXPECT_EQ(blocks[1].available, available);
+}
+
+TEST_F(PoolNumaTestFixture, byte_allocate_uses_local_pool) {
+    EXPECT_TRUE(pool_numa_set_add(&set, 0, NULL, &bytes[0]));
+    uint8_t *memory = (uint8_t *) pool_numa_byte_allocate(&set, 64);
+
+    EXPECT_GE(memory, byte_memory[0]);
+    EXPECT_LT(memory, byte_memory[0] + sizeof(byte_memory[0]));
+    EXPECT_EQ(set.remote, 0);
+    EXPECT_EQ(pool_numa_block_allocate(&set), nullptr);
+
+    // too large for the node's pool
+    EXPECT_EQ(pool_numa_byte_allocate(&set, 1024), nullptr);
+    size_t capacity = bytes[0].capacity;
+    pool_numa_byte_release(&set, memory);
+    EXPECT_GT(bytes[0].capacity, capacity);
+}
+
+TEST_F(PoolNumaTestFixture, byte_release_ignores_memory_outside_the_set) {
+    EXPECT_TRUE(pool_numa_set_add(&set, 0, NULL, &bytes[0]));
+    void   *memory  = byte_allocate(&bytes[1], 64);
+    size_t capacity = bytes[1].capacity;
+
+    pool_numa_byte_release(&set, memory);
+    pool_numa_byte_release(&set, NULL);
+    pool_numa_byte_release(NULL, memory);
+    EXPECT_EQ(bytes[1].capacity, capacity);
+    byte_release(memory);
+}
+
+TEST_F(PoolNumaTestFixture, byte_allocate_is_safe_across_threads) {
+    std::vector<std::thread> workers;
+    size_t                   capacity = bytes[0].capacity;
+
+    EXPECT_TRUE(pool_numa_set_add(&set, 0, NULL, &bytes[0]));
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([this]() {
+            for (int i = 0; i < 10000; i++) {
+                void *memory = pool_numa_byte_allocate(&set, 16);
+                if (memory != NULL) {
+                    pool_numa_byte_release(&set, memory);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // every allocation went back, merged into a single free block again
+    byte_pool_defragment(&bytes[0]);
+    EXPECT_EQ(bytes[0].capacity, capacity);
+}
+
+TEST_F(PoolNumaTestFixture, allocate_skips_nodes_without_pools) {
+    size_t available = blocks[1].available;
+
+    EXPECT_TRUE(pool_numa_set_add(&set, 1, &blocks[1], NULL));
+    EXPECT_EQ(set.count, 2);
+
+    uint8_t *memory = (uint8_t *) pool_numa_block_allocate(&set);
+    EXPECT_GE(memory, block_memory[1]);
+    EXPECT_LT(memory, block_memory[1] + sizeof(block_memory[1]));
+    EXPECT_EQ(blocks[1].available, available - 1);
+    block_release(memory);
+    EXPECT_EQ(blocks[1].available, available);
+}
@@ -0,0 +1,195 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "pool_profile.h"
+#include "byte_pool.h"
+
+class PoolProfileTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        pool_profile_init(&profile, sites, 8, samples, 4, 64);
+    }
+
+    void TearDown() {
+        pool_profile_attach(NULL);
+    }
+
+    /* bytes a sample stands for at the fixture's rate of 64 */
+    static uint64_t Weight(size_t size) {
+        return (uint64_t) ((double) size / -std::expm1(-(double) size / 64) + 0.5);
+    }
+
+    /* each call is its own call site */
+    void __attribute__((noinline)) SampleHere(const void *address, size_t size) {
+        pool_profile_sample(&profile, address, size);
+        asm volatile("");
+    }
+
+    void __attribute__((noinline)) SampleThere(const void *address, size_t size) {
+        pool_profile_sample(&profile, address, size);
+        asm volatile("");
+    }
+
+    pool_profile_t        profile;
+    pool_profile_site_t   sites[8];
+    pool_profile_sample_t samples[4];
+    pool_profile_site_t   copy[8];
+    int                   blocks[8];
+};
+
+TEST_F(PoolProfileTestFixture, init_configures_tables) {
+    EXPECT_EQ(profile.sites, sites);
+    EXPECT_EQ(profile.site_capacity, 8);
+    EXPECT_EQ(profile.samples, samples);
+    EXPECT_EQ(profile.sample_capacity, 4);
+    EXPECT_EQ(profile.rate, 64);
+    EXPECT_EQ(pool_profile_read(&profile, copy, 8), 0);
+
+    pool_profile_init(&profile, sites, 8, samples, 4, 0);
+    EXPECT_EQ(profile.rate, POOL_PROFILE_RATE);
+}
+
+TEST_F(PoolProfileTestFixture, sample_records_only_when_attached) {
+    SampleHere(&blocks[0], 16);
+    EXPECT_EQ(pool_profile_read(&profile, copy, 8), 0);
+    EXPECT_EQ(pool_profile_live, 0);
+
+    pool_profile_attach(&profile);
+    EXPECT_EQ(pool_profile_live, 0);
+    SampleHere(&blocks[0], 16);
+    ASSERT_EQ(pool_profile_read(&profile, copy, 8), 1);
+    EXPECT_EQ(copy[0].pool, &profile);
+    EXPECT_GT(copy[0].depth, 0);
+    EXPECT_EQ(copy[0].live_count, 1);
+    EXPECT_EQ(pool_profile_live, 1);
+
+    pool_profile_release(&blocks[0]);
+    EXPECT_EQ(pool_profile_live, 0);
+}
+
+TEST_F(PoolProfileTestFixture, sample_weights_by_inverse_sampling_chance) {
+    pool_profile_attach(&profile);
+    for (size_t size : {16, 100}) {
+        SampleHere(&blocks[size / 100], size);
+    }
+
+    // small allocations stand for about rate bytes, large ones for about their size
+    EXPECT_GT(Weight(16), 64);
+    EXPECT_LT(Weight(16), 64 + 16);
+    EXPECT_GE(Weight(6400), 6400);
+    EXPECT_LT(Weight(6400), 6400 + 64);
+
+    ASSERT_EQ(pool_profile_read(&profile, copy, 8), 1);
+    EXPECT_EQ(copy[0].live_bytes, Weight(16) + Weight(100));
+    EXPECT_EQ(copy[0].total_bytes, Weight(16) + Weight(100));
+    EXPECT_EQ(copy[0].live_count, 2);
+
+    pool_profile_release(&blocks[1]);
+    pool_profile_release(&blocks[0]);
+}
+
+TEST_F(PoolProfileTestFixture, release_drops_live_bytes_but_keeps_totals) {
+    pool_profile_attach(&profile);
+    SampleHere(&blocks[0], 128);
+    pool_profile_release(&blocks[0]);
+    pool_profile_release(&blocks[0]);
+    pool_profile_release(&blocks[1]);
+
+    ASSERT_EQ(pool_profile_read(&profile, copy, 8), 1);
+    EXPECT_EQ(copy[0].live_bytes, 0);
+    EXPECT_EQ(copy[0].live_count, 0);
+    EXPECT_EQ(copy[0].total_bytes, Weight(128));
+    EXPECT_EQ(pool_profile_live, 0);
+}
+
+TEST_F(PoolProfileTestFixture, read_orders_sites_by_live_bytes) {
+    pool_profile_attach(&profile);
+    SampleHere(&blocks[0], 100);
+    SampleThere(&blocks[1], 300);
+
+    ASSERT_EQ(pool_profile_read(&profile, copy, 8), 2);
+    EXPECT_EQ(copy[0].live_bytes, Weight(300));
+    EXPECT_EQ(copy[1].live_bytes, Weight(100));
+
+    ASSERT_EQ(pool_profile_read(&profile, copy, 1), 1);
+    EXPECT_EQ(copy[0].live_bytes, Weight(300));
+
+    pool_profile_release(&blocks[0]);
+    pool_profile_release(&blocks[1]);
+}
+
+TEST_F(PoolProfileTestFixture, move_follows_sample_to_new_address) {
+    pool_profile_attach(&profile);
+    SampleHere(&blocks[0], 100);
+    pool_profile_move(&blocks[0], &blocks[5]);
+
+    pool_profile_release(&blocks[0]);
+    EXPECT_EQ(pool_profile_live, 1);
+    pool_profile_release(&blocks[5]);
+    EXPECT_EQ(pool_profile_live, 0);
+}
+
+TEST_F(PoolProfileTestFixture, full_sample_table_drops_samples) {
+    pool_profile_attach(&profile);
+    for (int i = 0; i < 5; i++) {
+        SampleHere(&blocks[i], 64);
+    }
+    EXPECT_EQ(profile.dropped, 1);
+    EXPECT_EQ(profile.live, 4);
+
+    // released slots are reused
+    for (int i = 0; i < 4; i++) {
+        pool_profile_release(&blocks[i]);
+    }
+    SampleHere(&blocks[4], 64);
+    EXPECT_EQ(profile.live, 1);
+    pool_profile_release(&blocks[4]);
+}
+
+TEST_F(PoolProfileTestFixture, dump_reports_sites_with_live_memory) {
+    char    text[4096] = {};
+    int     fds[2];
+    ssize_t length;
+
+    pool_profile_attach(&profile);
+    SampleHere(&blocks[0], 100);
+    SampleThere(&blocks[1], 300);
+    pool_profile_release(&blocks[0]);
+
+    ASSERT_EQ(pipe(fds), 0);
+    EXPECT_EQ(pool_profile_dump(&profile, fds[1]), 1);
+    close(fds[1]);
+    length = read(fds[0], text, sizeof(text) - 1);
+    close(fds[0]);
+
+    ASSERT_GT(length, 0);
+    std::string expected = std::to_string(Weight(300)) + " live bytes in 1 samples";
+    EXPECT_EQ(strncmp(text, expected.c_str(), expected.size()), 0);
+    pool_profile_release(&blocks[1]);
+}
+
+#ifdef CPOOL_PROFILE
+TEST_F(PoolProfileTestFixture, byte_pool_samples_allocations) {
+    uint8_t     buffer[256];
+    byte_pool_t pool;
+
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    pool_profile_attach(&profile);
+
+    pool_profile_countdown = 0;
+    void *memory = byte_allocate(&pool, 32);
+    ASSERT_EQ(pool_profile_read(&profile, copy, 8), 1);
+    EXPECT_EQ(copy[0].pool, &pool);
+    EXPECT_EQ(copy[0].live_bytes, Weight(32));
+
+    byte_release(memory);
+    EXPECT_EQ(pool_profile_live, 0);
+}
+#endif
@@ -0,0 +1,230 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "pool_purge.h"
+#include "byte_pool.h"
+#include "byte_map_pool.h"
+#include "segment_pool.h"
+
+class PoolPurgeTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        page  = (size_t) sysconf(_SC_PAGESIZE);
+        size  = 16 * page;
+        arena = (uint8_t *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        ASSERT_NE(arena, MAP_FAILED);
+        memset(arena, 0xa5, size);
+        pool_purge_init(&purge, POOL_PURGE_DONTNEED, 0, 0);
+    }
+
+    void TearDown() override {
+        munmap(arena, size);
+    }
+
+    bool PageIsZero(uint8_t *memory) {
+        for (size_t i = 0; i < page; i++) {
+            if (memory[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t       page  = 0;
+    size_t       size  = 0;
+    uint8_t      *arena = nullptr;
+    pool_purge_t purge = {};
+};
+
+TEST_F(PoolPurgeTestFixture, range_ignores_bad_inputs) {
+    EXPECT_EQ(pool_purge_range(NULL, arena, arena + size), 0);
+    EXPECT_EQ(pool_purge_range(&purge, arena + size, arena), 0);
+    EXPECT_FALSE(pool_purge_ready(NULL));
+}
+
+TEST_F(PoolPurgeTestFixture, range_purges_only_whole_pages) {
+    EXPECT_EQ(pool_purge_range(&purge, arena + 1, arena + page), 0);
+    EXPECT_EQ(pool_purge_range(&purge, arena + 1, arena + 3 * page - 1), page);
+    EXPECT_EQ(arena[page - 1], 0xa5);
+    EXPECT_TRUE(PageIsZero(arena + page));
+    EXPECT_EQ(arena[2 * page], 0xa5);
+}
+
+TEST_F(PoolPurgeTestFixture, free_advice_purges_range) {
+    pool_purge_init(&purge, POOL_PURGE_FREE, 0, 0);
+    EXPECT_EQ(pool_purge_range(&purge, arena, arena + size), size);
+}
+
+TEST_F(PoolPurgeTestFixture, interval_rate_limits_purges) {
+    byte_pool_t pool = {};
+    byte_pool_init(&pool, arena, size);
+    pool_purge_init(&purge, POOL_PURGE_DONTNEED, 0, 60ull * 1000000000ull);
+
+    EXPECT_GT(byte_pool_purge(&pool, &purge), 0);
+    EXPECT_EQ(byte_pool_purge(&pool, &purge), 0);
+}
+
+TEST_F(PoolPurgeTestFixture, threshold_waits_for_released_memory) {
+    byte_pool_t pool = {};
+    byte_pool_init(&pool, arena, size);
+    pool_purge_init(&purge, POOL_PURGE_DONTNEED, 4 * page, 0);
+
+    EXPECT_GT(byte_pool_purge(&pool, &purge), 0);
+    void *memory = byte_allocate(&pool, 8 * page);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(byte_pool_purge(&pool, &purge), 0);
+
+    byte_release(memory);
+    EXPECT_GT(byte_pool_purge(&pool, &purge), 0);
+}
+
+TEST_F(PoolPurgeTestFixture, byte_pool_purge_keeps_headers) {
+    byte_pool_t pool = {};
+    byte_pool_init(&pool, arena, size);
+
+    uint8_t *first  = (uint8_t *) byte_allocate(&pool, 4 * page);
+    uint8_t *second = (uint8_t *) byte_allocate(&pool, 4 * page);
+    uint8_t *third  = (uint8_t *) byte_allocate(&pool, page);
+    memset(third, 0x5a, page);
+    byte_release(first);
+    byte_release(second);
+    size_t capacity = pool.capacity;
+
+    size_t purged = byte_pool_purge(&pool, &purge);
+    EXPECT_GE(purged, 6 * page);
+    EXPECT_EQ(byte_pool_purge(&pool, &purge), purged);
+    EXPECT_EQ(purge.purged, 2 * purged);
+    EXPECT_TRUE(PageIsZero(arena + page));
+    EXPECT_EQ(third[page - 1], 0x5a);
+    EXPECT_GE(pool.capacity, capacity);
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+
+    uint8_t *again = (uint8_t *) byte_allocate(&pool, 8 * page);
+    ASSERT_NE(again, nullptr);
+    memset(again, 1, 8 * page);
+    byte_release(again);
+    byte_release(third);
+    EXPECT_TRUE(byte_pool_is_valid(&pool));
+}
+
+TEST_F(PoolPurgeTestFixture, segment_pool_purge_keeps_links) {
+    segment_pool_t pool = {};
+    segment_pool_init(&pool, 2 * page, arena, arena + size);
+
+    // the run after first keeps its link and end in its first page
+    void *first = segment_allocate(&pool);
+    EXPECT_EQ(segment_pool_purge(&pool, &purge), size - 3 * page);
+    EXPECT_TRUE(PageIsZero(arena + 3 * page));
+    EXPECT_EQ(arena[page], 0xa5);
+
+    size_t count = 1;
+    while (segment_allocate(&pool) != NULL) {
+        count++;
+    }
+    EXPECT_EQ(count, size / (2 * page));
+    segment_release(&pool, first);
+}
+
+TEST_F(PoolPurgeTestFixture, segment_pool_purge_frees_pages_of_small_segments) {
+    segment_pool_t             pool = {};
+    std::vector<unsigned char> resident(size / page);
+    std::set<void *>           allocations;
+    void                       *segment;
+
+    segment_pool_init(&pool, 64, arena, arena + size);
+    void *first = segment_allocate(&pool);
+
+    // release in reverse so the free list is out of address order
+    std::vector<void *> taken;
+    while ((segment = segment_allocate(&pool)) != NULL) {
+        taken.push_back(segment);
+    }
+    for (auto it = taken.rbegin(); it != taken.rend(); ++it) {
+        segment_release(&pool, *it);
+    }
+
+    EXPECT_EQ(segment_pool_purge(&pool, &purge), size - page);
+    ASSERT_EQ(mincore(arena, size, resident.data()), 0);
+    for (size_t i = 1; i < size / page; i++) {
+        EXPECT_EQ(resident[i] & 1, 0) << i;
+    }
+
+    // a second purge finds nothing new
+    EXPECT_EQ(segment_pool_purge(&pool, &purge), 0);
+
+    // reuse only touches the pages it hands out
+    EXPECT_EQ(segment_allocate(&pool), arena + 64);
+    EXPECT_EQ(segment_allocate(&pool), arena + 128);
+    ASSERT_EQ(mincore(arena, size, resident.data()), 0);
+    EXPECT_EQ(resident[2] & 1, 0);
+
+    allocations.insert(arena + 64);
+    allocations.insert(arena + 128);
+    while ((segment = segment_allocate(&pool)) != NULL) {
+        EXPECT_GE((uint8_t *) segment, arena);
+        EXPECT_LT((uint8_t *) segment, arena + size);
+        EXPECT_TRUE(allocations.insert(segment).second);
+    }
+    EXPECT_EQ(allocations.size(), size / 64 - 1);
+    segment_release(&pool, first);
+}
+
+TEST_F(PoolPurgeTestFixture, segment_pool_purge_keeps_ordered_release_working) {
+    segment_pool_t pool = {};
+    segment_pool_init(&pool, 64, arena, arena + size);
+
+    uint8_t *first  = (uint8_t *) segment_allocate(&pool);
+    uint8_t *second = (uint8_t *) segment_allocate(&pool);
+    segment_release(&pool, first);
+    EXPECT_EQ(segment_pool_purge(&pool, &purge), size - page);
+
+    // lands between the lone first segment and the purged run
+    segment_ordered_release(&pool, second);
+    size_t count = 0;
+    while (segment_allocate(&pool) != NULL) {
+        count++;
+    }
+    EXPECT_EQ(count, size / 64);
+}
+
+TEST_F(PoolPurgeTestFixture, segment_pool_purge_run_allocates_zeroed) {
+    segment_pool_t pool = {};
+    segment_pool_init(&pool, 64, arena, arena + size);
+    segment_pool_mark_zeroed(&pool);
+    EXPECT_EQ(segment_pool_purge(&pool, &purge), size - page);
+
+    // the run's link and end words are cleared along with the rest
+    for (int i = 0; i < 3; i++) {
+        uint8_t *segment = (uint8_t *) segment_allocate_zeroed(&pool);
+        ASSERT_NE(segment, nullptr);
+        for (size_t j = 0; j < 2 * sizeof(void *); j++) {
+            EXPECT_EQ(segment[j], 0) << i;
+        }
+    }
+}
+
+TEST_F(PoolPurgeTestFixture, byte_map_pool_purge_frees_whole_runs) {
+    byte_map_pool_t pool = {};
+    uint64_t        metadata[BYTE_MAP_METADATA_SIZE(1 << 20) / sizeof(uint64_t)];
+    byte_map_pool_init(&pool, metadata, sizeof(metadata), arena, size);
+
+    uint8_t *first  = (uint8_t *) byte_map_allocate(&pool, 4 * page);
+    uint8_t *second = (uint8_t *) byte_map_allocate(&pool, page);
+    memset(second, 0x5a, page);
+    byte_map_release(&pool, first);
+
+    EXPECT_EQ(byte_map_pool_purge(&pool, &purge), size - page);
+    EXPECT_TRUE(PageIsZero(arena));
+    EXPECT_EQ(second[0], 0x5a);
+    EXPECT_TRUE(PageIsZero(arena + 5 * page));
+
+    EXPECT_NE(byte_map_allocate(&pool, 4 * page), nullptr);
+    EXPECT_EQ(pool.capacity, size - 5 * page);
+}
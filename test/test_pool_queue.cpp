@@ -0,0 +1,113 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "pool_queue.h"
+
+class PoolQueueTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        block_pool_init(&pool, POOL_NODE_SIZE, buffer, buffer + sizeof(buffer));
+        pool_queue_init(&queue, &pool);
+    }
+
+    block_pool_t        pool = {};
+    pool_queue_t        queue = {};
+    alignas(16) uint8_t buffer[64 * (POOL_NODE_SIZE + sizeof(void *))];
+};
+
+TEST_F(PoolQueueTestFixture, init_takes_dummy_node) {
+    EXPECT_EQ(queue.pool, &pool);
+    EXPECT_EQ(pool.available, pool.capacity - 1);
+    EXPECT_EQ(queue.head, queue.tail);
+}
+
+TEST_F(PoolQueueTestFixture, init_ignores_bad_inputs) {
+    pool_queue_t empty = {};
+    block_pool_t small = {};
+    block_pool_init(&small, sizeof(void *), buffer, buffer + sizeof(buffer));
+
+    pool_queue_init(&empty, NULL);
+    pool_queue_init(&empty, &small);
+    EXPECT_EQ(empty.pool, nullptr);
+    EXPECT_FALSE(pool_queue_push(&empty, NULL));
+    EXPECT_FALSE(pool_queue_pop(&empty, NULL));
+}
+
+TEST_F(PoolQueueTestFixture, pop_returns_values_in_order) {
+    void *value;
+    EXPECT_FALSE(pool_queue_pop(&queue, &value));
+    for (uintptr_t i = 1; i <= 3; i++) {
+        EXPECT_TRUE(pool_queue_push(&queue, (void *) i));
+    }
+    for (uintptr_t i = 1; i <= 3; i++) {
+        ASSERT_TRUE(pool_queue_pop(&queue, &value));
+        EXPECT_EQ(value, (void *) i);
+    }
+    EXPECT_FALSE(pool_queue_pop(&queue, &value));
+}
+
+TEST_F(PoolQueueTestFixture, push_fails_when_pool_is_empty_and_recycles_nodes) {
+    size_t count = 0;
+    while (pool_queue_push(&queue, NULL)) {
+        count++;
+    }
+    EXPECT_EQ(count, pool.capacity - 1);
+
+    EXPECT_TRUE(pool_queue_pop(&queue, NULL));
+    EXPECT_TRUE(pool_queue_push(&queue, NULL));
+    EXPECT_EQ(pool.available, 0);
+
+    while (pool_queue_pop(&queue, NULL)) {}
+    EXPECT_EQ(pool_queue_trim(&queue), pool.capacity - 1);
+    EXPECT_EQ(pool.available, pool.capacity - 1);
+}
+
+TEST_F(PoolQueueTestFixture, concurrent_producers_and_consumers_keep_order) {
+    const int                producers = 3;
+    const int                consumers = 3;
+    const uintptr_t          values    = 20000;
+    std::atomic<uint64_t>    popped(0);
+    std::atomic<int>         disorder(0);
+    std::vector<std::thread> workers;
+
+    for (int p = 0; p < producers; p++) {
+        workers.emplace_back([&, p]() {
+            for (uintptr_t i = 1; i <= values; i++) {
+                while (!pool_queue_push(&queue, (void *) (i << 8 | p))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        workers.emplace_back([&]() {
+            uintptr_t last[producers] = {};
+            void      *value;
+            while (popped < producers * values) {
+                if (!pool_queue_pop(&queue, &value)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                uintptr_t producer = (uintptr_t) value & 0xff;
+                if (((uintptr_t) value >> 8) <= last[producer]) {
+                    disorder++;
+                }
+                last[producer] = (uintptr_t) value >> 8;
+                popped++;
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(disorder, 0);
+    EXPECT_EQ(popped, producers * values);
+    EXPECT_FALSE(pool_queue_pop(&queue, NULL));
+}
@@ -0,0 +1,167 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "pool_shrink.h"
+#include "block_pool.h"
+#include "byte_pool.h"
+
+/* cache of allocations dropped on request */
+struct ShrinkCache {
+    std::vector<void *> blocks;
+    void                (*release)(void *);
+    size_t              size;
+    size_t              calls = 0;
+    size_t              target = 0;
+};
+
+static size_t DropCache(void *context, size_t target) {
+    ShrinkCache *cache    = (ShrinkCache *) context;
+    size_t      released = 0;
+
+    cache->calls++;
+    cache->target = target;
+    while (released < target && !cache->blocks.empty()) {
+        cache->release(cache->blocks.back());
+        cache->blocks.pop_back();
+        released += cache->size;
+    }
+    return released;
+}
+
+static size_t ReleaseNothing(void *context, size_t target) {
+    (*(size_t *) context)++;
+    return 0;
+}
+
+class PoolShrinkTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        pool_shrink_init(&shrink);
+    }
+
+    pool_shrink_t   shrink;
+    pool_shrinker_t shrinkers[2];
+};
+
+TEST_F(PoolShrinkTestFixture, shrink_without_shrinkers_releases_nothing) {
+    EXPECT_EQ(pool_shrink(&shrink, 64), 0);
+    EXPECT_EQ(pool_shrink(NULL, 64), 0);
+}
+
+TEST_F(PoolShrinkTestFixture, shrinkers_run_newest_first_until_target_is_met) {
+    size_t      calls = 0;
+    ShrinkCache cache;
+    cache.release = [](void *) {};
+    cache.size    = 16;
+    cache.blocks.assign(8, nullptr);
+
+    pool_shrinker_add(&shrink, &shrinkers[0], ReleaseNothing, &calls);
+    pool_shrinker_add(&shrink, &shrinkers[1], DropCache, &cache);
+
+    EXPECT_EQ(pool_shrink(&shrink, 40), 48);
+    EXPECT_EQ(cache.blocks.size(), 5);
+    EXPECT_EQ(calls, 0);
+
+    EXPECT_EQ(pool_shrink(&shrink, 200), 80);
+    EXPECT_EQ(cache.target, 200);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(PoolShrinkTestFixture, removed_shrinker_no_longer_runs) {
+    size_t calls = 0;
+
+    pool_shrinker_add(&shrink, &shrinkers[0], ReleaseNothing, &calls);
+    pool_shrinker_add(&shrink, &shrinkers[1], ReleaseNothing, &calls);
+    pool_shrinker_remove(&shrink, &shrinkers[1]);
+    pool_shrink(&shrink, 1);
+    EXPECT_EQ(calls, 1);
+
+    pool_shrinker_remove(&shrink, &shrinkers[0]);
+    EXPECT_EQ(shrink.shrinkers, nullptr);
+}
+
+TEST_F(PoolShrinkTestFixture, byte_allocate_retries_after_shrinking) {
+    uint8_t     buffer[256];
+    byte_pool_t pool;
+    ShrinkCache cache;
+    void        *memory;
+
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    cache.release = byte_release;
+    cache.size    = 64;
+    while ((memory = byte_allocate(&pool, 64)) != NULL) {
+        cache.blocks.push_back(memory);
+    }
+    pool_shrinker_add(&pool.shrink, &shrinkers[0], DropCache, &cache);
+
+    memory = byte_allocate(&pool, 64);
+    EXPECT_NE(memory, nullptr);
+    EXPECT_EQ(cache.calls, 1);
+    EXPECT_EQ(cache.target, 64 + 2 * sizeof(void *));
+    EXPECT_EQ(cache.blocks.size(), 1);
+
+    // more than the cache can give back still fails
+    EXPECT_EQ(byte_allocate(&pool, 256), nullptr);
+    EXPECT_EQ(cache.calls, 2);
+}
+
+TEST_F(PoolShrinkTestFixture, byte_allocate_shrinks_below_watermark) {
+    uint8_t     buffer[256];
+    byte_pool_t pool;
+    ShrinkCache cache;
+
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    cache.release = byte_release;
+    cache.size    = 32;
+    pool_shrinker_add(&pool.shrink, &shrinkers[0], DropCache, &cache);
+    pool_shrink_watermark(&pool.shrink, 128);
+
+    cache.blocks.push_back(byte_allocate(&pool, 32));
+    EXPECT_EQ(cache.calls, 0);
+    cache.blocks.push_back(byte_allocate(&pool, 32));
+    cache.blocks.push_back(byte_allocate(&pool, 32));
+
+    // capacity went below 128, the cache gave back enough to cover the gap
+    EXPECT_EQ(cache.calls, 1);
+    EXPECT_GE(pool.capacity, 128 - 48);
+}
+
+TEST_F(PoolShrinkTestFixture, block_allocate_retries_after_shrinking) {
+    void         *buffer[64];
+    block_pool_t pool;
+    ShrinkCache  cache;
+    void         *block;
+
+    block_pool_init(&pool, 16, buffer, buffer + 64);
+    cache.release = block_release;
+    cache.size    = 16;
+
+    for (size_t i = 0; i < pool.capacity; i++) {
+        cache.blocks.push_back(block_allocate(&pool));
+    }
+    EXPECT_EQ(cache.calls, 0);
+    pool_shrinker_add(&pool.shrink, &shrinkers[0], DropCache, &cache);
+
+    block = block_allocate(&pool);
+    EXPECT_NE(block, nullptr);
+    EXPECT_EQ(cache.calls, 1);
+    EXPECT_EQ(cache.target, 16);
+    block_release(block);
+}
+
+TEST_F(PoolShrinkTestFixture, shrinker_allocating_from_its_pool_does_not_recurse) {
+    void         *buffer[16];
+    block_pool_t pool;
+
+    block_pool_init(&pool, 16, buffer, buffer + 16);
+    pool_shrinker_add(&pool.shrink, &shrinkers[0], [](void *context, size_t) -> size_t {
+        return block_allocate((block_pool_t *) context) == NULL ? 0 : 16;
+    }, &pool);
+
+    while (block_allocate(&pool) != NULL) {}
+    EXPECT_EQ(pool.shrink.running, 0);
+}
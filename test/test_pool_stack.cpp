@@ -0,0 +1,100 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "pool_stack.h"
+
+class PoolStackTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        block_pool_init(&pool, POOL_NODE_SIZE, buffer, buffer + sizeof(buffer));
+        pool_stack_init(&stack, &pool);
+    }
+
+    block_pool_t        pool = {};
+    pool_stack_t        stack = {};
+    alignas(16) uint8_t buffer[64 * (POOL_NODE_SIZE + sizeof(void *))];
+};
+
+TEST_F(PoolStackTestFixture, init_ignores_bad_inputs) {
+    pool_stack_t empty = {};
+    block_pool_t small = {};
+    block_pool_init(&small, sizeof(void *), buffer, buffer + sizeof(buffer));
+
+    pool_stack_init(&empty, NULL);
+    pool_stack_init(&empty, &small);
+    EXPECT_EQ(empty.pool, nullptr);
+    EXPECT_FALSE(pool_stack_push(&empty, NULL));
+    EXPECT_FALSE(pool_stack_pop(&empty, NULL));
+}
+
+TEST_F(PoolStackTestFixture, pop_returns_values_in_reverse_order) {
+    void *value;
+    for (uintptr_t i = 1; i <= 3; i++) {
+        EXPECT_TRUE(pool_stack_push(&stack, (void *) i));
+    }
+    for (uintptr_t i = 3; i >= 1; i--) {
+        ASSERT_TRUE(pool_stack_pop(&stack, &value));
+        EXPECT_EQ(value, (void *) i);
+    }
+    EXPECT_FALSE(pool_stack_pop(&stack, &value));
+}
+
+TEST_F(PoolStackTestFixture, push_fails_when_pool_is_empty_and_recycles_nodes) {
+    size_t count = 0;
+    while (pool_stack_push(&stack, NULL)) {
+        count++;
+    }
+    EXPECT_EQ(count, pool.capacity);
+    EXPECT_EQ(pool.available, 0);
+
+    EXPECT_TRUE(pool_stack_pop(&stack, NULL));
+    EXPECT_TRUE(pool_stack_push(&stack, NULL));
+    EXPECT_EQ(pool.available, 0);
+
+    while (pool_stack_pop(&stack, NULL)) {}
+    EXPECT_EQ(pool_stack_trim(&stack), pool.capacity);
+    EXPECT_EQ(pool.available, pool.capacity);
+}
+
+TEST_F(PoolStackTestFixture, concurrent_push_and_pop_keep_every_value) {
+    const int                threads = 4;
+    const uintptr_t          values  = 20000;
+    std::atomic<uint64_t>    sum(0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            void *value;
+            for (uintptr_t i = 1; i <= values; i++) {
+                while (!pool_stack_push(&stack, (void *) (i * threads + t))) {
+                    std::this_thread::yield();
+                }
+                if (pool_stack_pop(&stack, &value)) {
+                    sum += (uintptr_t) value;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    void *value;
+    while (pool_stack_pop(&stack, &value)) {
+        sum += (uintptr_t) value;
+    }
+
+    uint64_t expected = 0;
+    for (int t = 0; t < threads; t++) {
+        for (uintptr_t i = 1; i <= values; i++) {
+            expected += i * threads + t;
+        }
+    }
+    EXPECT_EQ(sum, expected);
+}
@@ -0,0 +1,111 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "pool_trace.h"
+#include "byte_pool.h"
+
+class PoolTraceTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        pool_trace_init(&trace, events, sizeof(events));
+    }
+
+    void TearDown() {
+        pool_trace_attach(NULL);
+    }
+
+    pool_trace_t       trace;
+    pool_trace_event_t events[4];
+    pool_trace_event_t copy[8];
+};
+
+TEST_F(PoolTraceTestFixture, init_configures_ring) {
+    EXPECT_EQ(trace.events, events);
+    EXPECT_EQ(trace.capacity, 4);
+    EXPECT_EQ(trace.head, 0);
+    EXPECT_EQ(pool_trace_count(&trace), 0);
+}
+
+TEST_F(PoolTraceTestFixture, record_stores_event_fields) {
+    int pool = 0, block = 0;
+    pool_trace_record(&trace, POOL_TRACE_ALLOCATE, &pool, &block, 24);
+
+    ASSERT_EQ(pool_trace_read(&trace, copy, 8), 1);
+    EXPECT_EQ(copy[0].type, POOL_TRACE_ALLOCATE);
+    EXPECT_EQ(copy[0].pool, (uintptr_t) &pool);
+    EXPECT_EQ(copy[0].address, (uintptr_t) &block);
+    EXPECT_EQ(copy[0].size, 24);
+}
+
+TEST_F(PoolTraceTestFixture, read_returns_oldest_first_after_wrap) {
+    for (int i = 0; i < 6; i++) {
+        pool_trace_record(&trace, POOL_TRACE_SIZE, NULL, NULL, i);
+    }
+
+    EXPECT_EQ(pool_trace_count(&trace), 4);
+    ASSERT_EQ(pool_trace_read(&trace, copy, 8), 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(copy[i].size, i + 2);
+    }
+
+    // max limits copy to oldest events
+    ASSERT_EQ(pool_trace_read(&trace, copy, 2), 2);
+    EXPECT_EQ(copy[1].size, 3);
+}
+
+TEST_F(PoolTraceTestFixture, emit_records_only_when_attached) {
+    pool_trace_emit(POOL_TRACE_RELEASE, NULL, NULL, 8);
+    EXPECT_EQ(pool_trace_count(&trace), 0);
+
+    pool_trace_attach(&trace);
+    pool_trace_emit(POOL_TRACE_RELEASE, NULL, NULL, 8);
+    EXPECT_EQ(pool_trace_count(&trace), 1);
+}
+
+TEST_F(PoolTraceTestFixture, save_writes_header_and_events) {
+    pool_trace_file_t header;
+    char              path[] = "pool_trace_test.bin";
+
+    EXPECT_EQ(pool_trace_save(&trace, path), 0);
+
+    pool_trace_record(&trace, POOL_TRACE_ALLOCATE, NULL, NULL, 1);
+    pool_trace_record(&trace, POOL_TRACE_RELEASE, NULL, NULL, 2);
+    ASSERT_EQ(pool_trace_save(&trace, path), 2);
+
+    FILE *file = fopen(path, "rb");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1);
+    EXPECT_EQ(memcmp(header.magic, POOL_TRACE_MAGIC, sizeof(header.magic)), 0);
+    EXPECT_EQ(header.version, POOL_TRACE_VERSION);
+    EXPECT_EQ(header.event_size, sizeof(pool_trace_event_t));
+    EXPECT_EQ(header.count, 2);
+    ASSERT_EQ(fread(copy, sizeof(pool_trace_event_t), 3, file), 2);
+    EXPECT_EQ(copy[1].type, POOL_TRACE_RELEASE);
+    fclose(file);
+    remove(path);
+}
+
+#ifdef CPOOL_TRACE
+TEST_F(PoolTraceTestFixture, byte_pool_emits_events) {
+    uint8_t     buffer[256];
+    byte_pool_t pool;
+
+    byte_pool_init(&pool, buffer, sizeof(buffer));
+    pool_trace_attach(&trace);
+
+    void *memory = byte_allocate(&pool, 32);
+    byte_size(memory);
+    byte_release(memory);
+
+    ASSERT_EQ(pool_trace_read(&trace, copy, 8), 3);
+    EXPECT_EQ(copy[0].type, POOL_TRACE_ALLOCATE);
+    EXPECT_EQ(copy[0].address, (uintptr_t) memory);
+    EXPECT_EQ(copy[1].type, POOL_TRACE_SIZE);
+    EXPECT_EQ(copy[2].type, POOL_TRACE_RELEASE);
+    EXPECT_EQ(copy[2].size, 32);
+}
+#endif
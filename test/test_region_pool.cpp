@@ -0,0 +1,197 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <set>
+#include "region_pool.h"
+
+class RegionPoolTestFixture : public testing::Test {
+public:
+
+    void PoolInit() {
+        region_pool_init(&region, buffer, sizeof(buffer));
+    }
+
+    region_pool_t region = {};
+    alignas(REGION_ALIGNMENT) uint8_t buffer[512];
+};
+
+TEST_F(RegionPoolTestFixture, init_ignores_bad_inputs) {
+    region_pool_init(NULL, buffer, sizeof(buffer));
+    region_pool_init(&region, NULL, sizeof(buffer));
+    EXPECT_FALSE(region_pool_is_valid(&region));
+    region_pool_init(&region, buffer, sizeof(region_chunk_t));
+    EXPECT_FALSE(region_pool_is_valid(&region));
+    EXPECT_EQ(region_allocate(&region, 8), nullptr);
+}
+
+TEST_F(RegionPoolTestFixture, allocate_bumps_without_headers) {
+    PoolInit();
+    EXPECT_TRUE(region_pool_is_valid(&region));
+    uint8_t *first  = (uint8_t *) region_allocate(&region, 1);
+    uint8_t *second = (uint8_t *) region_allocate(&region, 16);
+    uint8_t *third  = (uint8_t *) region_allocate(&region, 8);
+
+    EXPECT_EQ((uintptr_t) first % REGION_ALIGNMENT, 0);
+    EXPECT_EQ(second, first + REGION_ALIGNMENT);
+    EXPECT_EQ(third, second + 16);
+}
+
+TEST_F(RegionPoolTestFixture, allocate_ignores_bad_inputs) {
+    PoolInit();
+    EXPECT_EQ(region_allocate(NULL, 8), nullptr);
+    EXPECT_EQ(region_allocate(&region, 0), nullptr);
+    EXPECT_EQ(region_allocate(&region, sizeof(buffer)), nullptr);
+    EXPECT_EQ(region_allocate(&region, SIZE_MAX), nullptr);
+}
+
+TEST_F(RegionPoolTestFixture, allocate_returns_null_when_full_without_source) {
+    PoolInit();
+    size_t count = 0;
+    while (region_allocate(&region, 16) != NULL) {
+        count++;
+    }
+    EXPECT_GT(count, 0);
+    EXPECT_EQ(region_allocate(&region, 16), nullptr);
+}
+
+TEST_F(RegionPoolTestFixture, rewind_drops_allocations_after_mark) {
+    PoolInit();
+    region_allocate(&region, 32);
+    region_mark_t mark = region_mark(&region);
+    void *after = region_allocate(&region, 64);
+    region_allocate(&region, 64);
+
+    region_rewind(&region, mark);
+    EXPECT_EQ(region_allocate(&region, 64), after);
+}
+
+TEST_F(RegionPoolTestFixture, reset_drops_every_allocation) {
+    PoolInit();
+    void *first = region_allocate(&region, 64);
+    while (region_allocate(&region, 64) != NULL) {}
+
+    region_reset(&region);
+    EXPECT_EQ(region_allocate(&region, 64), first);
+}
+
+TEST_F(RegionPoolTestFixture, segment_source_supplies_chunks) {
+    alignas(64) uint8_t memory[64 * 16];
+    segment_pool_t      segments;
+    std::set<void *>    allocations;
+    void                *allocation;
+
+    segment_pool_init(&segments, 64, memory, memory + sizeof(memory));
+    region_pool_init(&region, NULL, 0);
+    region_pool_segment_source(&region, &segments);
+    EXPECT_TRUE(region_pool_is_valid(&region));
+
+    while ((allocation = region_allocate(&region, 16)) != NULL) {
+        EXPECT_GE((uint8_t *) allocation, memory);
+        EXPECT_LT((uint8_t *) allocation, memory + sizeof(memory));
+        EXPECT_TRUE(allocations.insert(allocation).second);
+    }
+    EXPECT_TRUE(segment_pool_empty(&segments));
+
+    // every chunk goes back to the segment pool
+    EXPECT_EQ(region_pool_release(&region), sizeof(memory));
+    for (size_t i = 0; i < sizeof(memory) / 64; i++) {
+        EXPECT_NE(segment_allocate(&segments), nullptr);
+    }
+    EXPECT_TRUE(segment_pool_empty(&segments));
+}
+
+TEST_F(RegionPoolTestFixture, segment_source_spans_segments_for_large_allocations) {
+    alignas(64) uint8_t memory[64 * 16];
+    segment_pool_t      segments;
+
+    segment_pool_init(&segments, 64, memory, memory + sizeof(memory));
+    region_pool_init(&region, NULL, 0);
+    region_pool_segment_source(&region, &segments);
+
+    uint8_t *large = (uint8_t *) region_allocate(&region, 200);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(region.chunk->size, 256);
+    EXPECT_LE((char *) large + 200, region.chunk->end);
+
+    EXPECT_EQ(region_pool_release(&region), 256);
+    for (size_t i = 0; i < sizeof(memory) / 64; i++) {
+        EXPECT_NE(segment_allocate(&segments), nullptr);
+    }
+}
+
+TEST_F(RegionPoolTestFixture, rewind_keeps_chunks_for_reuse) {
+    alignas(64) uint8_t memory[64 * 4];
+    segment_pool_t      segments;
+
+    segment_pool_init(&segments, 64, memory, memory + sizeof(memory));
+    region_pool_init(&region, buffer, 64);
+    region_pool_segment_source(&region, &segments);
+
+    region_mark_t mark = region_mark(&region);
+    void *first = region_allocate(&region, 32);
+    void *spill = region_allocate(&region, 32);
+    EXPECT_NE(region.chunk, region.first);
+
+    // chunks past the mark stay linked so refilling takes nothing from the source
+    region_rewind(&region, mark);
+    EXPECT_EQ(region_allocate(&region, 32), first);
+    EXPECT_EQ(region_allocate(&region, 32), spill);
+    EXPECT_EQ(region.first->next, region.chunk);
+    EXPECT_EQ(region.chunk->next, nullptr);
+
+    // trimming after a rewind returns the spare chunk, the caller's chunk stays
+    region_rewind(&region, mark);
+    EXPECT_EQ(region_pool_trim(&region), 64);
+    EXPECT_EQ(region.first->next, nullptr);
+    EXPECT_EQ(region_allocate(&region, 32), first);
+}
+
+TEST_F(RegionPoolTestFixture, byte_source_supplies_chunks) {
+    alignas(sizeof(void *)) uint8_t memory[1024];
+    byte_pool_t                     bytes;
+
+    byte_pool_init(&bytes, memory, sizeof(memory));
+    size_t capacity = bytes.capacity;
+
+    region_pool_init(&region, NULL, 0);
+    region_pool_byte_source(&region, &bytes, 128);
+
+    uint8_t *small = (uint8_t *) region_allocate(&region, 16);
+    uint8_t *large = (uint8_t *) region_allocate(&region, 300);
+    EXPECT_NE(small, nullptr);
+    EXPECT_NE(large, nullptr);
+    EXPECT_GE(small, memory);
+    EXPECT_LT(large + 300, memory + sizeof(memory));
+    EXPECT_LT(bytes.capacity, capacity - 428);
+
+    region_pool_release(&region);
+    EXPECT_EQ(bytes.capacity, capacity);
+    EXPECT_EQ(region.first, nullptr);
+    EXPECT_NE(region_allocate(&region, 16), nullptr);
+}
+
+TEST_F(RegionPoolTestFixture, byte_source_keeps_byte_pool_headers_aligned) {
+    alignas(sizeof(void *)) uint8_t memory[1024];
+    byte_pool_t                     bytes;
+
+    byte_pool_init(&bytes, memory, sizeof(memory));
+    region_pool_init(&region, NULL, 0);
+    region_pool_byte_source(&region, &bytes, 101);
+    EXPECT_EQ(region.chunk_size % (2 * sizeof(void *)), 0);
+
+    // odd chunk sizes and allocations spanning their own chunk split the byte pool at whole headers
+    EXPECT_NE(region_allocate(&region, 8), nullptr);
+    EXPECT_NE(region_allocate(&region, 203), nullptr);
+    for (region_chunk_t *chunk = region.first; chunk != NULL; chunk = chunk->next) {
+        EXPECT_EQ((uintptr_t) chunk % sizeof(void *), 0);
+        EXPECT_EQ(chunk->size % (2 * sizeof(void *)), 0);
+    }
+
+    void *after = byte_allocate(&bytes, 8);
+    EXPECT_NE(after, nullptr);
+    EXPECT_EQ((uintptr_t) after % sizeof(void *), 0);
+    byte_release(after);
+    region_pool_release(&region);
+}
@@ -0,0 +1,130 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include "segment_chain.h"
+
+class SegmentChainTestFixture : public testing::Test {
+public:
+
+    void SetUp() override {
+        segment_pool_init(&pool, segment, buffer, buffer + sizeof(buffer));
+        while ((memory = segment_allocate(&pool)) != NULL) {
+            total++;
+        }
+        /* release every other segment so no two free segments are adjacent */
+        for (size_t i = 0; i < total; i += 2) {
+            segment_release(&pool, buffer + i * segment);
+            free_count++;
+        }
+    }
+
+    size_t Available() {
+        size_t count = 0;
+        for (void *search = pool.search; search != NULL; search = *(void **) search) {
+            count++;
+        }
+        return count;
+    }
+
+    const size_t        payload = 64 - SEGMENT_CHAIN_HEADER;
+    const size_t        segment = 64;
+    segment_pool_t      pool = {};
+    void                *memory = nullptr;
+    size_t              total = 0;
+    size_t              free_count = 0;
+    alignas(64) uint8_t buffer[16 * 64];
+};
+
+TEST_F(SegmentChainTestFixture, allocate_ignores_bad_inputs) {
+    segment_slice_t slice;
+    segment_pool_t  small = {};
+    uint64_t        small_buffer[8];
+    segment_pool_init(&small, SEGMENT_CHAIN_HEADER, small_buffer, small_buffer + 8);
+
+    EXPECT_FALSE(segment_chain_allocate(&pool, NULL, 10));
+    EXPECT_FALSE(segment_chain_allocate(&pool, &slice, 0));
+    EXPECT_FALSE(segment_chain_allocate(&small, &slice, 10));
+    EXPECT_EQ(slice.first, nullptr);
+    EXPECT_EQ(slice.length, 0);
+}
+
+TEST_F(SegmentChainTestFixture, allocate_spans_fragmented_segments) {
+    segment_slice_t slice;
+    struct iovec    iov[8];
+
+    ASSERT_TRUE(segment_chain_allocate(&pool, &slice, 3 * payload + 1));
+    EXPECT_EQ(Available(), free_count - 4);
+    EXPECT_EQ(segment_allocate_size(&pool, 2 * segment), nullptr);
+
+    ASSERT_EQ(segment_chain_iovec(&slice, iov, 8), 4);
+    size_t length = 0;
+    for (int i = 0; i < 4; i++) {
+        memset(iov[i].iov_base, i, iov[i].iov_len);
+        length += iov[i].iov_len;
+    }
+    EXPECT_EQ(length, 3 * payload + 1);
+    EXPECT_EQ(iov[3].iov_len, 1);
+    EXPECT_EQ(segment_chain_iovec(&slice, iov, 2), 2);
+
+    segment_chain_release(&slice);
+    EXPECT_EQ(Available(), free_count);
+    EXPECT_EQ(slice.first, nullptr);
+}
+
+TEST_F(SegmentChainTestFixture, allocate_failure_returns_taken_segments) {
+    segment_slice_t slice;
+    EXPECT_FALSE(segment_chain_allocate(&pool, &slice, (free_count + 1) * payload));
+    EXPECT_EQ(Available(), free_count);
+    EXPECT_EQ(slice.first, nullptr);
+}
+
+TEST_F(SegmentChainTestFixture, allocate_rejects_huge_sizes) {
+    segment_slice_t slice;
+    EXPECT_FALSE(segment_chain_allocate(&pool, &slice, SIZE_MAX));
+    EXPECT_FALSE(segment_chain_allocate(&pool, &slice, SIZE_MAX - payload + 2));
+    EXPECT_EQ(Available(), free_count);
+    EXPECT_EQ(slice.first, nullptr);
+    EXPECT_EQ(slice.length, 0);
+}
+
+TEST_F(SegmentChainTestFixture, share_keeps_segments_until_last_slice_released) {
+    segment_slice_t slice;
+    segment_slice_t header;
+    segment_slice_t body;
+    struct iovec    iov[4];
+
+    ASSERT_TRUE(segment_chain_allocate(&pool, &slice, 3 * payload));
+    segment_chain_iovec(&slice, iov, 4);
+    memset(iov[1].iov_base, 0x5a, payload);
+
+    segment_chain_share(&header, &slice, 0, 8);
+    segment_chain_share(&body, &slice, payload + 4, 10 * payload);
+    EXPECT_EQ(body.length, 2 * payload - 4);
+    EXPECT_EQ(body.offset, 4);
+
+    segment_chain_release(&slice);
+    EXPECT_EQ(Available(), free_count - 3);
+
+    ASSERT_EQ(segment_chain_iovec(&body, iov, 4), 2);
+    EXPECT_EQ(iov[0].iov_len, payload - 4);
+    EXPECT_EQ(*(uint8_t *) iov[0].iov_base, 0x5a);
+
+    segment_chain_release(&header);
+    EXPECT_EQ(Available(), free_count - 2);
+    segment_chain_release(&body);
+    EXPECT_EQ(Available(), free_count);
+}
+
+TEST_F(SegmentChainTestFixture, share_ignores_range_past_end) {
+    segment_slice_t slice;
+    segment_slice_t shared;
+
+    ASSERT_TRUE(segment_chain_allocate(&pool, &slice, payload));
+    segment_chain_share(&shared, &slice, payload, 1);
+    EXPECT_EQ(shared.first, nullptr);
+    segment_chain_release(&shared);
+    segment_chain_release(&slice);
+    EXPECT_EQ(Available(), free_count);
+}
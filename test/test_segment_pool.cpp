@@ -4,6 +4,10 @@
 
 #include <gtest/gtest.h>
 #include <segment_pool.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 class SegmentPoolTestFixture : public testing::Test {
 public:
@@ -36,3 +40,109 @@ TEST_F(SegmentPoolTestFixture, init_should_ignore_bad_inputs) {
 
 }
 
+TEST_F(SegmentPoolTestFixture, init_leaves_pool_empty_when_smaller_than_a_segment) {
+    void *buffer[8];
+    segment_pool_t pool;
+
+    buffer[0] = buffer;
+    segment_pool_init(&pool, 8 * sizeof(void *), buffer, buffer + 7);
+    EXPECT_TRUE(segment_pool_empty(&pool));
+    EXPECT_EQ(segment_allocate(&pool), nullptr);
+    EXPECT_EQ(buffer[0], buffer);
+
+    segment_pool_init(&pool, sizeof(void *), buffer + 4, buffer);
+    EXPECT_TRUE(segment_pool_empty(&pool));
+}
+
+TEST_F(SegmentPoolTestFixture, allocate_wait_times_out_on_empty_pool) {
+    void *buffer[8];
+    segment_pool_t pool;
+
+    segment_pool_init(&pool, sizeof(void *), buffer, buffer + 8);
+    segment_pool_mark_shared(&pool);
+    EXPECT_NE(segment_allocate_wait(&pool, 0), nullptr);
+    while (segment_allocate(&pool) != NULL);
+
+    EXPECT_EQ(segment_allocate_wait(&pool, 1000000), nullptr);
+    EXPECT_EQ(pool.waiters, 0);
+}
+
+TEST_F(SegmentPoolTestFixture, allocate_wait_returns_at_once_on_unshared_pool) {
+    void *buffer[8];
+    segment_pool_t pool;
+
+    segment_pool_init(&pool, sizeof(void *), buffer, buffer + 8);
+    while (segment_allocate(&pool) != NULL);
+
+    // no other thread can release into it, so there is nothing to wait for
+    EXPECT_EQ(segment_allocate_wait(&pool, UINT64_MAX), nullptr);
+    EXPECT_EQ(pool.lock, 0);
+}
+
+TEST_F(SegmentPoolTestFixture, release_size_wakes_one_waiter_per_segment) {
+    void *buffer[8];
+    segment_pool_t pool;
+
+    segment_pool_init(&pool, sizeof(void *), buffer, buffer + 8);
+    segment_pool_mark_shared(&pool);
+    void *run = segment_allocate_size(&pool, 2 * sizeof(void *));
+    ASSERT_NE(run, nullptr);
+    while (segment_allocate(&pool) != NULL);
+
+    std::atomic<int> woken(0);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 3; i++) {
+        waiters.emplace_back([&pool, &woken]() {
+            if (segment_allocate_wait(&pool, 500000000) != NULL) {
+                woken++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    segment_release_size(&pool, run, 2 * sizeof(void *));
+
+    for (auto &waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(woken, 2);
+    EXPECT_TRUE(segment_pool_empty(&pool));
+    EXPECT_EQ(pool.waiters, 0);
+}
+
+TEST_F(SegmentPoolTestFixture, allocate_zeroed_clears_used_segments) {
+    uint64_t       buffer[32];
+    segment_pool_t pool;
+
+    memset(buffer, 0xa5, sizeof(buffer));
+    segment_pool_init(&pool, 4 * sizeof(uint64_t), buffer, buffer + 32);
+
+    // memory isn't known to be zero, so even a new segment is cleared
+    uint64_t *segment = (uint64_t *) segment_allocate_zeroed(&pool);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(segment[i], 0);
+    }
+
+    memset(segment, 0xff, 4 * sizeof(uint64_t));
+    segment_release(&pool, segment);
+    segment_pool_mark_zeroed(&pool);
+    EXPECT_EQ(segment_allocate_zeroed(&pool), segment);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(segment[i], 0);
+    }
+}
+
+TEST_F(SegmentPoolTestFixture, allocate_zeroed_skips_untouched_segments_of_zeroed_pool) {
+    uint64_t       buffer[32];
+    segment_pool_t pool;
+
+    // pretend the memory is zero to see what gets cleared
+    memset(buffer, 0xa5, sizeof(buffer));
+    segment_pool_init(&pool, 4 * sizeof(uint64_t), buffer, buffer + 32);
+    segment_pool_mark_zeroed(&pool);
+
+    uint64_t *segment = (uint64_t *) segment_allocate_zeroed(&pool);
+    EXPECT_EQ(segment[0], 0);
+    EXPECT_EQ(segment[1], 0xa5a5a5a5a5a5a5a5);
+    EXPECT_EQ(pool.untouched, segment + 4);
+}
@@ -0,0 +1,123 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+
+#include <gtest/gtest.h>
+#include <shard_pool.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+class ShardPoolTestFixture : public testing::Test {
+public:
+
+    void SetUp() {
+        shard_pool_init(&pool, shards, 4, sizeof(buffer[0]), buffer, buffer + 256);
+    }
+
+    size_t CachedSegments() {
+        size_t count = 0;
+        for (int i = 0; i < 4; i++) {
+            count += shards[i].count;
+        }
+        return count;
+    }
+
+    struct segment {
+        void *next;
+        long data;
+    };
+
+    segment      buffer[256];
+    shard_t      shards[4];
+    shard_pool_t pool;
+};
+
+TEST_F(ShardPoolTestFixture, init_sets_up_empty_shards) {
+    EXPECT_EQ(pool.shard_count, 4);
+    EXPECT_EQ(pool.batch, SHARD_POOL_BATCH);
+    EXPECT_EQ(pool.global.start, buffer);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(shards[i].count, 0);
+        EXPECT_EQ(shards[i].cache.search, nullptr);
+    }
+}
+
+TEST_F(ShardPoolTestFixture, allocate_refills_shard_in_batches) {
+    void *segment = shard_allocate(&pool);
+    ASSERT_NE(segment, nullptr);
+    EXPECT_EQ(CachedSegments(), SHARD_POOL_BATCH - 1);
+}
+
+TEST_F(ShardPoolTestFixture, allocate_returns_every_segment_until_empty) {
+    std::set<void *> allocations;
+    for (int i = 0; i < 256; i++) {
+        void *segment = shard_allocate(&pool);
+        ASSERT_NE(segment, nullptr);
+        EXPECT_GE(segment, (void *) buffer);
+        EXPECT_LT(segment, (void *) (buffer + 256));
+        allocations.insert(segment);
+    }
+    EXPECT_EQ(allocations.size(), 256);
+    EXPECT_EQ(shard_allocate(&pool), nullptr);
+}
+
+TEST_F(ShardPoolTestFixture, release_spills_excess_to_global_pool) {
+    std::vector<void *> allocations;
+    for (int i = 0; i < 3 * SHARD_POOL_BATCH; i++) {
+        allocations.push_back(shard_allocate(&pool));
+    }
+    for (void *segment : allocations) {
+        shard_release(&pool, segment);
+    }
+    EXPECT_LT(CachedSegments(), 2 * SHARD_POOL_BATCH);
+}
+
+TEST_F(ShardPoolTestFixture, trim_drains_only_idle_shards) {
+    shard_release(&pool, shard_allocate(&pool));
+    EXPECT_GT(CachedSegments(), 0);
+
+    // shard was active since init so the first trim only clears the flag
+    EXPECT_EQ(shard_pool_trim(&pool), 0);
+    EXPECT_EQ(shard_pool_trim(&pool), SHARD_POOL_BATCH);
+    EXPECT_EQ(CachedSegments(), 0);
+}
+
+TEST_F(ShardPoolTestFixture, drain_returns_segments_to_global_pool) {
+    shard_allocate(&pool);
+    size_t shard = shard_pool_current(&pool);
+    EXPECT_EQ(shard_pool_drain(&pool, shard), SHARD_POOL_BATCH - 1);
+    EXPECT_EQ(shard_pool_drain(&pool, pool.shard_count), 0);
+    EXPECT_EQ(CachedSegments(), 0);
+}
+
+TEST_F(ShardPoolTestFixture, concurrent_allocate_and_release) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([this]() {
+            void *segments[16];
+            for (int round = 0; round < 1000; round++) {
+                for (auto &segment : segments) {
+                    segment = shard_allocate(&pool);
+                    ASSERT_NE(segment, nullptr);
+                }
+                for (auto &segment : segments) {
+                    shard_release(&pool, segment);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < 4; i++) {
+        shard_pool_drain(&pool, i);
+    }
+    std::set<void *> allocations;
+    void *segment;
+    while ((segment = segment_allocate(&pool.global)) != NULL) {
+        allocations.insert(segment);
+    }
+    EXPECT_EQ(allocations.size(), 256);
+}
@@ -0,0 +1,272 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+// Replay a trace recorded with pool_trace against one of the pool engines.
+//
+// usage: cpool_replay [-e engine] [-a arena bytes] [-u unit bytes] trace
+//
+
+#include "pool_engine.h"
+#include "pool_trace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_POOLS_MAX 64
+
+typedef struct replay_pool_t {
+    uint64_t           id;
+    pool_engine_pool_t base;
+    size_t             live;
+    size_t             peak;
+    size_t             failures;
+} replay_pool_t;
+
+typedef struct replay_entry_t {
+    uint64_t address;
+    void     *memory;
+    size_t   size;
+} replay_entry_t;
+
+typedef struct replay_map_t {
+    replay_entry_t *entries;
+    size_t         capacity;
+    size_t         count;
+} replay_map_t;
+
+static size_t replay_map_slot(replay_map_t *map, uint64_t address) {
+    size_t slot = (size_t) ((address >> 3) * 0x9E3779B97F4A7C15ull) & (map->capacity - 1);
+    while (map->entries[slot].address != 0 && map->entries[slot].address != address) {
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+    return slot;
+}
+
+static void replay_map_insert(replay_map_t *map, uint64_t address, void *memory, size_t size);
+
+static void replay_map_grow(replay_map_t *map) {
+    replay_map_t grown = {calloc(map->capacity * 2, sizeof(replay_entry_t)), map->capacity * 2, 0};
+
+    if (grown.entries == NULL) {
+        fprintf(stderr, "cpool_replay: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->entries[i].address != 0) {
+            replay_map_insert(&grown, map->entries[i].address, map->entries[i].memory, map->entries[i].size);
+        }
+    }
+    free(map->entries);
+    *map = grown;
+}
+
+static void replay_map_insert(replay_map_t *map, uint64_t address, void *memory, size_t size) {
+    size_t slot;
+
+    if ((map->count + 1) * 2 > map->capacity) {
+        replay_map_grow(map);
+    }
+    slot = replay_map_slot(map, address);
+    if (map->entries[slot].address == 0) {
+        map->count++;
+    }
+    map->entries[slot] = (replay_entry_t) {address, memory, size};
+}
+
+static int replay_map_remove(replay_map_t *map, uint64_t address, replay_entry_t *entry) {
+    size_t slot = replay_map_slot(map, address);
+    size_t next;
+
+    if (map->entries[slot].address == 0) {
+        return 0;
+    }
+    *entry = map->entries[slot];
+    map->entries[slot].address = 0;
+    map->count--;
+
+    /* shift following entries of the probe run back so lookups stay correct */
+    next = (slot + 1) & (map->capacity - 1);
+    while (map->entries[next].address != 0) {
+        replay_entry_t moved = map->entries[next];
+        map->entries[next].address = 0;
+        map->count--;
+        replay_map_insert(map, moved.address, moved.memory, moved.size);
+        next = (next + 1) & (map->capacity - 1);
+    }
+    return 1;
+}
+
+static int replay_map_find(replay_map_t *map, uint64_t address, replay_entry_t *entry) {
+    size_t slot = replay_map_slot(map, address);
+    if (map->entries[slot].address == 0) {
+        return 0;
+    }
+    *entry = map->entries[slot];
+    return 1;
+}
+
+static uint64_t replay_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static replay_pool_t *replay_pool_get(replay_pool_t *pools, size_t *count, const pool_engine_t *engine,
+                                      uint64_t id, size_t size, size_t unit) {
+    for (size_t i = 0; i < *count; i++) {
+        if (pools[i].id == id) {
+            return &pools[i];
+        }
+    }
+
+    if (*count == REPLAY_POOLS_MAX) {
+        return NULL;
+    }
+
+    replay_pool_t *pool = &pools[(*count)++];
+    memset(pool, 0, sizeof(*pool));
+    pool->id         = id;
+    pool->base.size  = size;
+    pool->base.unit  = unit;
+    pool->base.arena = malloc(size);
+    if (pool->base.arena == NULL) {
+        fprintf(stderr, "cpool_replay: can't allocate %zu byte arena\n", size);
+        exit(EXIT_FAILURE);
+    }
+    engine->init(&pool->base);
+    return pool;
+}
+
+static void replay_usage(void) {
+    fprintf(stderr, "usage: cpool_replay [-e byte|byte_compact|byte_map|block|segment] [-a arena bytes] [-u unit bytes] trace\n"
+                    "  -e  pool engine to replay against (default byte)\n"
+                    "  -a  arena size per traced pool (default 1048576)\n"
+                    "  -u  block size for block engine, segment alignment for segment engine (default 64)\n");
+}
+
+int main(int argc, char **argv) {
+    const pool_engine_t   *engine = &pool_engines[0];
+    size_t                arena   = 1u << 20;
+    size_t                unit    = 64;
+    pool_trace_file_t     header;
+    pool_trace_event_t    event;
+    replay_pool_t         pools[REPLAY_POOLS_MAX];
+    size_t                pool_count = 0;
+    replay_map_t          map        = {calloc(1024, sizeof(replay_entry_t)), 1024, 0};
+    replay_entry_t        entry;
+    replay_pool_t         *pool;
+    size_t                operations = 0, failures = 0, recovered = 0, unmatched = 0, live = 0, peak = 0;
+    uint64_t              elapsed    = 0, start;
+    void                  *memory;
+    FILE                  *file;
+    int                   option;
+
+    while ((option = getopt(argc, argv, "e:a:u:h")) != -1) {
+        switch (option) {
+            case 'e':
+                if ((engine = pool_engine_find(optarg)) == NULL) {
+                    replay_usage();
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'a':
+                arena = strtoull(optarg, NULL, 0);
+                break;
+            case 'u':
+                unit = strtoull(optarg, NULL, 0);
+                break;
+            default:
+                replay_usage();
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc - 1 || arena == 0 || unit == 0 || map.entries == NULL) {
+        replay_usage();
+        return EXIT_FAILURE;
+    }
+
+    if ((file = fopen(argv[optind], "rb")) == NULL
+        || fread(&header, sizeof(header), 1, file) != 1
+        || memcmp(header.magic, POOL_TRACE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != POOL_TRACE_VERSION
+        || header.event_size != sizeof(pool_trace_event_t)) {
+        fprintf(stderr, "cpool_replay: %s is not a pool trace\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    while (fread(&event, sizeof(event), 1, file) == 1) {
+        pool = replay_pool_get(pools, &pool_count, engine, event.pool, arena, unit);
+        if (pool == NULL) {
+            continue;
+        }
+
+        switch (event.type) {
+            case POOL_TRACE_ALLOCATE:
+                start  = replay_now();
+                memory = engine->allocate(&pool->base, event.size);
+                elapsed += replay_now() - start;
+                operations++;
+
+                if (memory == NULL) {
+                    pool->failures += (event.address != 0);
+                    failures += (event.address != 0);
+                } else if (event.address == 0) {
+                    /* failed when traced, nothing will ever release it */
+                    recovered++;
+                    engine->release(&pool->base, memory, event.size);
+                } else {
+                    replay_map_insert(&map, event.address, memory, event.size);
+                    pool->live += event.size;
+                    live += event.size;
+                    pool->peak = (pool->live > pool->peak) ? pool->live : pool->peak;
+                    peak       = (live > peak) ? live : peak;
+                }
+                break;
+            case POOL_TRACE_RELEASE:
+                if (replay_map_remove(&map, event.address, &entry)) {
+                    start = replay_now();
+                    engine->release(&pool->base, entry.memory, entry.size);
+                    elapsed += replay_now() - start;
+                    operations++;
+                    pool->live -= entry.size;
+                    live -= entry.size;
+                } else {
+                    unmatched++;
+                }
+                break;
+            case POOL_TRACE_SIZE:
+                if (engine->query != NULL && replay_map_find(&map, event.address, &entry)) {
+                    start = replay_now();
+                    engine->query(&pool->base, entry.memory);
+                    elapsed += replay_now() - start;
+                    operations++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    fclose(file);
+
+    printf("engine:      %s\n", engine->name);
+    printf("events:      %llu\n", (unsigned long long) header.count);
+    printf("operations:  %zu\n", operations);
+    printf("throughput:  %.0f ops/s\n", elapsed ? operations * 1e9 / (double) elapsed : 0.0);
+    printf("peak usage:  %zu bytes\n", peak);
+    printf("failures:    %zu\n", failures);
+    printf("recovered:   %zu\n", recovered);
+    printf("unmatched:   %zu\n", unmatched);
+    printf("\n%-18s %12s %12s %10s\n", "pool", "peak", "fragments", "failures");
+    for (size_t i = 0; i < pool_count; i++) {
+        printf("0x%016llx %12zu %12zu %10zu\n", (unsigned long long) pools[i].id, pools[i].peak,
+               engine->fragments(&pools[i].base), pools[i].failures);
+        free(pools[i].base.arena);
+    }
+
+    free(map.entries);
+    return EXIT_SUCCESS;
+}
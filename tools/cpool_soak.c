@@ -0,0 +1,281 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+// Long running aging harness. Drives a pool engine with randomly sized
+// allocations of random lifetime and prints a csv time series of
+// allocation latency, capacity, fragments and failure rate.
+//
+// usage: cpool_soak [-e engine] [-a arena] [-u unit] [-n operations] [-i interval]
+//                   [-d distribution] [-l lifetime] [-m max live] [-f max failure rate] [-s seed]
+//
+
+#include "pool_engine.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef enum soak_shape_t {
+    SOAK_UNIFORM,
+    SOAK_EXPONENTIAL,
+    SOAK_BIMODAL,
+} soak_shape_t;
+
+typedef struct soak_distribution_t {
+    soak_shape_t shape;
+    double       small;   /* uniform min, exponential mean, bimodal small size */
+    double       large;   /* uniform max, bimodal large size */
+    double       percent; /* bimodal share of small sizes */
+} soak_distribution_t;
+
+typedef struct soak_object_t {
+    uint64_t death;
+    void     *memory;
+    size_t   size;
+} soak_object_t;
+
+typedef struct soak_heap_t {
+    soak_object_t *objects;
+    size_t        count;
+    size_t        capacity;
+} soak_heap_t;
+
+typedef struct soak_interval_t {
+    size_t   allocations;
+    size_t   failures;
+    uint64_t latency;
+    uint64_t latency_max;
+} soak_interval_t;
+
+static uint64_t soak_state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t soak_random(void) {
+    soak_state ^= soak_state >> 12;
+    soak_state ^= soak_state << 25;
+    soak_state ^= soak_state >> 27;
+    return soak_state * 0x2545F4914F6CDD1Dull;
+}
+
+static double soak_uniform(void) {
+    return (double) (soak_random() >> 11) / (double) (1ull << 53);
+}
+
+static double soak_exponential(double mean) {
+    return -log(1.0 - soak_uniform()) * mean;
+}
+
+static size_t soak_size(soak_distribution_t *distribution) {
+    double size;
+
+    switch (distribution->shape) {
+        case SOAK_EXPONENTIAL:
+            size = soak_exponential(distribution->small);
+            break;
+        case SOAK_BIMODAL:
+            size = (soak_uniform() * 100 < distribution->percent) ? distribution->small : distribution->large;
+            break;
+        case SOAK_UNIFORM:
+        default:
+            size = distribution->small + soak_uniform() * (distribution->large - distribution->small);
+            break;
+    }
+    return (size < 1) ? 1 : (size_t) size;
+}
+
+static int soak_parse(const char *text, soak_distribution_t *distribution) {
+    memset(distribution, 0, sizeof(*distribution));
+
+    if (sscanf(text, "uniform:%lf:%lf", &distribution->small, &distribution->large) == 2) {
+        distribution->shape = SOAK_UNIFORM;
+    } else if (sscanf(text, "exp:%lf", &distribution->small) == 1) {
+        distribution->shape = SOAK_EXPONENTIAL;
+    } else if (sscanf(text, "bimodal:%lf:%lf:%lf", &distribution->small, &distribution->large,
+                      &distribution->percent) == 3) {
+        distribution->shape = SOAK_BIMODAL;
+    } else {
+        return 0;
+    }
+    return distribution->small > 0;
+}
+
+static void soak_heap_push(soak_heap_t *heap, soak_object_t object) {
+    size_t child = heap->count++;
+    size_t parent;
+
+    while (child > 0 && heap->objects[parent = (child - 1) / 2].death > object.death) {
+        heap->objects[child] = heap->objects[parent];
+        child = parent;
+    }
+    heap->objects[child] = object;
+}
+
+static soak_object_t soak_heap_pop(soak_heap_t *heap) {
+    soak_object_t top  = heap->objects[0];
+    soak_object_t last = heap->objects[--heap->count];
+    size_t        parent = 0;
+    size_t        child;
+
+    while ((child = 2 * parent + 1) < heap->count) {
+        if (child + 1 < heap->count && heap->objects[child + 1].death < heap->objects[child].death) {
+            child++;
+        }
+        if (heap->objects[child].death >= last.death) {
+            break;
+        }
+        heap->objects[parent] = heap->objects[child];
+        parent = child;
+    }
+    heap->objects[parent] = last;
+    return top;
+}
+
+static uint64_t soak_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static void soak_usage(void) {
+    fprintf(stderr, "usage: cpool_soak [options]\n"
+                    "  -e  engine byte|byte_compact|byte_map|block|segment (default byte)\n"
+                    "  -a  arena size in bytes (default 16777216)\n"
+                    "  -u  block size or segment alignment (default 64)\n"
+                    "  -n  number of allocations (default 10000000)\n"
+                    "  -i  allocations per csv row (default 100000)\n"
+                    "  -d  size distribution uniform:MIN:MAX, exp:MEAN or bimodal:SMALL:LARGE:PERCENT\n"
+                    "      (default uniform:8:512)\n"
+                    "  -l  mean object lifetime in allocations (default 10000)\n"
+                    "  -m  max live objects (default 1000000)\n"
+                    "  -f  exit with failure when the overall failure rate exceeds this (default 1)\n"
+                    "  -s  random seed\n");
+}
+
+int main(int argc, char **argv) {
+    const pool_engine_t *engine      = &pool_engines[0];
+    pool_engine_pool_t  pool         = {NULL, 16u << 20, 64, {{0}}};
+    soak_distribution_t distribution = {SOAK_UNIFORM, 8, 512, 0};
+    soak_heap_t         heap         = {NULL, 0, 1000000};
+    soak_interval_t     interval     = {0};
+    soak_object_t       object;
+    uint64_t            operations   = 10000000;
+    uint64_t            every        = 100000;
+    double              lifetime     = 10000;
+    double              max_failure  = 1;
+    uint64_t            start        = soak_now();
+    uint64_t            before, latency, latency_total = 0;
+    size_t              failures     = 0, live = 0;
+    int                 option;
+
+    while ((option = getopt(argc, argv, "e:a:u:n:i:d:l:m:f:s:h")) != -1) {
+        switch (option) {
+            case 'e':
+                if ((engine = pool_engine_find(optarg)) == NULL) {
+                    soak_usage();
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'a':
+                pool.size = strtoull(optarg, NULL, 0);
+                break;
+            case 'u':
+                pool.unit = strtoull(optarg, NULL, 0);
+                break;
+            case 'n':
+                operations = strtoull(optarg, NULL, 0);
+                break;
+            case 'i':
+                every = strtoull(optarg, NULL, 0);
+                break;
+            case 'd':
+                if (!soak_parse(optarg, &distribution)) {
+                    soak_usage();
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'l':
+                lifetime = strtod(optarg, NULL);
+                break;
+            case 'm':
+                heap.capacity = strtoull(optarg, NULL, 0);
+                break;
+            case 'f':
+                max_failure = strtod(optarg, NULL);
+                break;
+            case 's':
+                soak_state = strtoull(optarg, NULL, 0) | 1;
+                break;
+            default:
+                soak_usage();
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc || pool.size == 0 || pool.unit == 0 || every == 0 || heap.capacity == 0) {
+        soak_usage();
+        return EXIT_FAILURE;
+    }
+
+    pool.arena   = malloc(pool.size);
+    heap.objects = malloc(heap.capacity * sizeof(soak_object_t));
+    if (pool.arena == NULL || heap.objects == NULL) {
+        fprintf(stderr, "cpool_soak: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    engine->init(&pool);
+
+    printf("allocations,seconds,latency_mean_ns,latency_max_ns,capacity,fragments,live_bytes,failure_rate\n");
+
+    for (uint64_t now = 1; now <= operations; now++) {
+        /* release everything that died before this allocation */
+        while (heap.count > 0 && heap.objects[0].death <= now) {
+            object = soak_heap_pop(&heap);
+            engine->release(&pool, object.memory, object.size);
+            live -= object.size;
+        }
+
+        object.size = soak_size(&distribution);
+        before      = soak_now();
+        object.memory = (heap.count < heap.capacity) ? engine->allocate(&pool, object.size) : NULL;
+        latency     = soak_now() - before;
+
+        interval.allocations++;
+        interval.latency += latency;
+        interval.latency_max = (latency > interval.latency_max) ? latency : interval.latency_max;
+        latency_total += latency;
+
+        if (object.memory == NULL) {
+            interval.failures++;
+            failures++;
+        } else {
+            object.death = now + 1 + (uint64_t) soak_exponential(lifetime);
+            soak_heap_push(&heap, object);
+            live += object.size;
+        }
+
+        if (now % every == 0 || now == operations) {
+            printf("%llu,%.3f,%.1f,%llu,%zu,%zu,%zu,%.6f\n",
+                   (unsigned long long) now,
+                   (soak_now() - start) / 1e9,
+                   (double) interval.latency / interval.allocations,
+                   (unsigned long long) interval.latency_max,
+                   engine->capacity(&pool),
+                   engine->fragments(&pool),
+                   live,
+                   (double) interval.failures / interval.allocations);
+            fflush(stdout);
+            memset(&interval, 0, sizeof(interval));
+        }
+    }
+
+    fprintf(stderr, "cpool_soak: %s engine, %llu allocations, %.1f ns mean latency, %.6f failure rate\n",
+            engine->name, (unsigned long long) operations,
+            operations ? (double) latency_total / operations : 0.0,
+            operations ? (double) failures / operations : 0.0);
+
+    free(heap.objects);
+    free(pool.arena);
+    return (operations && (double) failures / operations > max_failure) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
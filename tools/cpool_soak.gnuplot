@@ -0,0 +1,28 @@
+#
+# Chart cpool_soak output
+#
+# usage: gnuplot -e "input='soak.csv'" tools/cpool_soak.gnuplot > soak.png
+#
+
+if (!exists("input")) input = 'soak.csv'
+
+set terminal pngcairo size 1200,900
+set datafile separator ','
+set key autotitle columnhead
+set multiplot layout 2,2
+set xlabel 'allocations'
+set grid
+
+set title 'allocation latency (ns)'
+plot input using 1:3 with lines title 'mean', '' using 1:4 with lines title 'max'
+
+set title 'capacity (free bytes)'
+plot input using 1:5 with lines title 'capacity', '' using 1:7 with lines title 'live bytes'
+
+set title 'fragments'
+plot input using 1:6 with lines title 'fragments'
+
+set title 'failure rate'
+plot input using 1:8 with lines title 'failure rate'
+
+unset multiplot
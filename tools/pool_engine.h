@@ -0,0 +1,215 @@
+//
+// Created by Andrew Wade on 2026-10-19.
+//
+// Common interface over the pool engines for the command line tools.
+//
+
+#ifndef MEMORY_POOL_ENGINE_H
+#define MEMORY_POOL_ENGINE_H
+
+#include "block_pool.h"
+#include "byte_compact_pool.h"
+#include "byte_map_pool.h"
+#include "byte_pool.h"
+#include "segment_pool.h"
+#include <stddef.h>
+#include <string.h>
+
+typedef struct pool_engine_pool_t {
+    void   *arena;
+    size_t size;
+    size_t unit; /* block size for block engine, segment alignment for segment engine */
+    union {
+        byte_pool_t         byte;
+        byte_compact_pool_t byte_compact;
+        byte_map_pool_t     byte_map;
+        block_pool_t        block;
+        segment_pool_t      segment;
+    } engine;
+} pool_engine_pool_t;
+
+typedef struct pool_engine_t {
+    const char *name;
+    void       (*init)(pool_engine_pool_t *pool);
+    void       *(*allocate)(pool_engine_pool_t *pool, size_t size);
+    void       (*release)(pool_engine_pool_t *pool, void *memory, size_t size);
+    size_t     (*query)(pool_engine_pool_t *pool, void *memory);
+    size_t     (*capacity)(pool_engine_pool_t *pool);
+    size_t     (*fragments)(pool_engine_pool_t *pool);
+} pool_engine_t;
+
+static void byte_engine_init(pool_engine_pool_t *pool) {
+    byte_pool_init(&pool->engine.byte, pool->arena, pool->size);
+}
+
+static void *byte_engine_allocate(pool_engine_pool_t *pool, size_t size) {
+    return byte_allocate(&pool->engine.byte, size);
+}
+
+static void byte_engine_release(pool_engine_pool_t *pool, void *memory, size_t size) {
+    (void) pool;
+    (void) size;
+    byte_release(memory);
+}
+
+static size_t byte_engine_query(pool_engine_pool_t *pool, void *memory) {
+    (void) pool;
+    return byte_size(memory);
+}
+
+static size_t byte_engine_capacity(pool_engine_pool_t *pool) {
+    return pool->engine.byte.capacity;
+}
+
+static size_t byte_engine_fragments(pool_engine_pool_t *pool) {
+    return pool->engine.byte.fragments;
+}
+
+static void byte_compact_engine_init(pool_engine_pool_t *pool) {
+    byte_compact_pool_init(&pool->engine.byte_compact, pool->arena, pool->size);
+}
+
+static void *byte_compact_engine_allocate(pool_engine_pool_t *pool, size_t size) {
+    return byte_compact_allocate(&pool->engine.byte_compact, size);
+}
+
+static void byte_compact_engine_release(pool_engine_pool_t *pool, void *memory, size_t size) {
+    (void) size;
+    byte_compact_release(&pool->engine.byte_compact, memory);
+}
+
+static size_t byte_compact_engine_query(pool_engine_pool_t *pool, void *memory) {
+    return byte_compact_size(&pool->engine.byte_compact, memory);
+}
+
+static size_t byte_compact_engine_capacity(pool_engine_pool_t *pool) {
+    return pool->engine.byte_compact.capacity;
+}
+
+static size_t byte_compact_engine_fragments(pool_engine_pool_t *pool) {
+    return pool->engine.byte_compact.fragments;
+}
+
+static void byte_map_engine_init(pool_engine_pool_t *pool) {
+    /* bitmaps live at the front of the arena */
+    size_t metadata = (BYTE_MAP_METADATA_SIZE(pool->size) + BYTE_MAP_GRANULE - 1) & ~(size_t) (BYTE_MAP_GRANULE - 1);
+    byte_map_pool_init(&pool->engine.byte_map, pool->arena, metadata, (char *) pool->arena + metadata,
+                       pool->size - metadata);
+}
+
+static void *byte_map_engine_allocate(pool_engine_pool_t *pool, size_t size) {
+    return byte_map_allocate(&pool->engine.byte_map, size);
+}
+
+static void byte_map_engine_release(pool_engine_pool_t *pool, void *memory, size_t size) {
+    (void) size;
+    byte_map_release(&pool->engine.byte_map, memory);
+}
+
+static size_t byte_map_engine_query(pool_engine_pool_t *pool, void *memory) {
+    return byte_map_size(&pool->engine.byte_map, memory);
+}
+
+static size_t byte_map_engine_capacity(pool_engine_pool_t *pool) {
+    return pool->engine.byte_map.capacity;
+}
+
+static size_t byte_map_engine_fragments(pool_engine_pool_t *pool) {
+    return pool->engine.byte_map.fragments;
+}
+
+static void block_engine_init(pool_engine_pool_t *pool) {
+    block_pool_init(&pool->engine.block, pool->unit, pool->arena, (char *) pool->arena + pool->size);
+}
+
+static void *block_engine_allocate(pool_engine_pool_t *pool, size_t size) {
+    return (size <= pool->unit) ? block_allocate(&pool->engine.block) : NULL;
+}
+
+static void block_engine_release(pool_engine_pool_t *pool, void *memory, size_t size) {
+    (void) pool;
+    (void) size;
+    block_release(memory);
+}
+
+static size_t block_engine_capacity(pool_engine_pool_t *pool) {
+    return pool->engine.block.available * pool->engine.block.alignment;
+}
+
+static size_t block_engine_fragments(pool_engine_pool_t *pool) {
+    (void) pool;
+    return 0;
+}
+
+static void segment_engine_init(pool_engine_pool_t *pool) {
+    segment_pool_init(&pool->engine.segment, pool->unit, pool->arena, (char *) pool->arena + pool->size);
+}
+
+static size_t segment_engine_round(pool_engine_pool_t *pool, size_t size) {
+    size_t alignment = pool->engine.segment.alignment;
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static void *segment_engine_allocate(pool_engine_pool_t *pool, size_t size) {
+    if (segment_engine_round(pool, size) == pool->engine.segment.alignment) {
+        return segment_allocate(&pool->engine.segment);
+    }
+    return segment_allocate_size(&pool->engine.segment, segment_engine_round(pool, size));
+}
+
+static void segment_engine_release(pool_engine_pool_t *pool, void *memory, size_t size) {
+    if (segment_engine_round(pool, size) == pool->engine.segment.alignment) {
+        segment_release(&pool->engine.segment, memory);
+    } else {
+        segment_release_size(&pool->engine.segment, memory, segment_engine_round(pool, size));
+    }
+}
+
+static size_t segment_engine_capacity(pool_engine_pool_t *pool) {
+    size_t capacity = 0;
+    char   *search  = pool->engine.segment.search;
+
+    while (search != NULL) {
+        capacity += pool->engine.segment.alignment;
+        search = *(char **) search;
+    }
+    return capacity;
+}
+
+static size_t segment_engine_fragments(pool_engine_pool_t *pool) {
+    size_t fragments = 0;
+    char   *search   = pool->engine.segment.search;
+
+    /* every break in address order starts a new free run */
+    while (search != NULL) {
+        if (*(char **) search != search + pool->engine.segment.alignment) {
+            fragments++;
+        }
+        search = *(char **) search;
+    }
+    return fragments;
+}
+
+static const pool_engine_t pool_engines[] = {
+    {"byte",    byte_engine_init,    byte_engine_allocate,    byte_engine_release,    byte_engine_query,
+        byte_engine_capacity,    byte_engine_fragments},
+    {"byte_compact", byte_compact_engine_init, byte_compact_engine_allocate, byte_compact_engine_release,
+        byte_compact_engine_query, byte_compact_engine_capacity, byte_compact_engine_fragments},
+    {"byte_map", byte_map_engine_init, byte_map_engine_allocate, byte_map_engine_release, byte_map_engine_query,
+        byte_map_engine_capacity, byte_map_engine_fragments},
+    {"block",   block_engine_init,   block_engine_allocate,   block_engine_release,   NULL,
+        block_engine_capacity,   block_engine_fragments},
+    {"segment", segment_engine_init, segment_engine_allocate, segment_engine_release, NULL,
+        segment_engine_capacity, segment_engine_fragments},
+};
+
+static const pool_engine_t *pool_engine_find(const char *name) {
+    for (size_t i = 0; i < sizeof(pool_engines) / sizeof(pool_engines[0]); i++) {
+        if (strcmp(name, pool_engines[i].name) == 0) {
+            return &pool_engines[i];
+        }
+    }
+    return NULL;
+}
+
+#endif //MEMORY_POOL_ENGINE_H
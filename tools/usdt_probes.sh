@@ -0,0 +1,21 @@
+#!/bin/sh
+#
+# Check every cpool USDT probe made it into the stapsdt notes of a binary
+# built against the real sys/sdt.h
+#
+# usage: tools/usdt_probes.sh <binary or libcpool_malloc.so>
+#
+
+notes=$(readelf -n "$1") || exit 1
+status=0
+
+for probe in byte_allocate_start byte_allocate byte_release byte_block_split byte_block_merge_next \
+             block_allocate_start block_allocate block_release block_release_list \
+             segment_allocate segment_allocate_size segment_release; do
+    if ! printf '%s\n' "$notes" | grep -q "Name: $probe\$"; then
+        echo "missing probe cpool:$probe"
+        status=1
+    fi
+done
+
+exit $status